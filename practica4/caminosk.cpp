@@ -0,0 +1,190 @@
+#include "caminosk.h"
+#include "paralelo.h"
+#include <algorithm>
+#include <functional>
+#include <set>
+using namespace std;
+
+namespace {
+
+// Búferes de un hilo para los desvíos. Un nodo/enlace está prohibido o tiene
+// distancia válida solo si su sello coincide con el sello del desvío actual,
+// así que "limpiar" es incrementar el sello.
+struct Espacio {
+    vector<long long> g;
+    vector<int> previo;
+    vector<unsigned> selloG, selloNodo, selloEnlace;
+    vector<pair<long long,int>> monticulo;
+    unsigned sello = 0;
+
+    void preparar(int n, int m) {
+        if ((int)g.size() != n) {
+            g.assign(n, 0);
+            previo.assign(n, -1);
+            selloG.assign(n, 0);
+            selloNodo.assign(n, 0);
+        }
+        if ((int)selloEnlace.size() != m) selloEnlace.assign(m, 0);
+        if (++sello == 0) { // desborde: reiniciar los sellos
+            fill(selloG.begin(), selloG.end(), 0);
+            fill(selloNodo.begin(), selloNodo.end(), 0);
+            fill(selloEnlace.begin(), selloEnlace.end(), 0);
+            sello = 1;
+        }
+        monticulo.clear();
+    }
+};
+
+template <class Motor>
+int enlaceEntre(const Motor& motor, int u, int v) {
+    for (int k = motor.inicio(u); k < motor.fin(u); ++k)
+        if (motor.destino(k) == v) return motor.enlaceDeArco(k);
+    return -1;
+}
+
+template <class Motor>
+vector<CaminoK> yen(const Motor& motor, int origen, int destino, int k, int hilos) {
+    using Costo = typename Motor::TipoCosto;
+    int n = motor.cantidadNodos();
+    int m = motor.cantidadEnlaces();
+    vector<CaminoK> aceptados;
+    if (k <= 0 || origen < 0 || destino < 0 || origen >= n || destino >= n) return aceptados;
+
+    // Árbol de caminos mínimos hacia el destino (los enlaces son bidireccionales)
+    ArbolCaminos<Costo> haciaDestino;
+    motor.arbolCaminos(destino, haciaDestino);
+    const vector<Costo>& h = haciaDestino.dist;
+    if (h[origen] == Motor::SIN_CONEXION) return aceptados;
+
+    auto siguienteEnArbol = [&](int v, int& enlace) {
+        enlace = motor.enlaceDeArco(haciaDestino.arcoPrevio[v]);
+        return motor.otroExtremo(enlace, v);
+    };
+
+    CaminoK primero;
+    primero.costo = h[origen];
+    for (int v = origen, e; ; v = siguienteEnArbol(v, e)) {
+        primero.nodos.push_back(v);
+        if (v == destino) break;
+    }
+    aceptados.push_back(primero);
+
+    set<pair<long long, vector<int>>> candidatos;
+    set<vector<int>> vistos{primero.nodos};
+    vector<Espacio> espacios(hilosAUsar(hilos, n));
+
+    while ((int)aceptados.size() < k) {
+        const vector<int> anterior = aceptados.back().nodos;
+        int desvios = (int)anterior.size() - 1;
+
+        // Costo acumulado de la raíz hasta cada nodo del camino anterior
+        vector<long long> costoRaiz(anterior.size(), 0);
+        for (int j = 1; j < (int)anterior.size(); ++j) {
+            int e = enlaceEntre(motor, anterior[j - 1], anterior[j]);
+            costoRaiz[j] = costoRaiz[j - 1] + get<2>(motor.enlace(e));
+        }
+
+        vector<CaminoK> encontrados(desvios);
+        // Con pocos desvíos no compensa lanzar hilos
+        int hilosDesvio = desvios >= 8 ? hilos : 1;
+
+        paraCadaEnParalelo(desvios, hilosDesvio, [&](int j, int hilo) {
+            Espacio& esp = espacios[hilo];
+            esp.preparar(n, m);
+            int nodoDesvio = anterior[j];
+
+            for (int t = 0; t < j; ++t) esp.selloNodo[anterior[t]] = esp.sello;
+            for (auto& camino : aceptados) {
+                const vector<int>& q = camino.nodos;
+                if ((int)q.size() <= j + 1) continue;
+                if (!equal(q.begin(), q.begin() + j + 1, anterior.begin())) continue;
+                esp.selloEnlace[enlaceEntre(motor, q[j], q[j + 1])] = esp.sello;
+            }
+
+            CaminoK& res = encontrados[j];
+            res.nodos.assign(anterior.begin(), anterior.begin() + j);
+
+            // Atajo: el camino del árbol desde el desvío ya es óptimo si no
+            // pasa por nada prohibido
+            bool libre = true;
+            for (int v = nodoDesvio, e; v != destino; ) {
+                int w = siguienteEnArbol(v, e);
+                if (esp.selloEnlace[e] == esp.sello || esp.selloNodo[w] == esp.sello) {
+                    libre = false;
+                    break;
+                }
+                v = w;
+            }
+            if (libre) {
+                for (int v = nodoDesvio, e; ; v = siguienteEnArbol(v, e)) {
+                    res.nodos.push_back(v);
+                    if (v == destino) break;
+                }
+                res.costo = costoRaiz[j] + (long long)h[nodoDesvio];
+                return;
+            }
+
+            // A* hacia el destino con h = distancia exacta en el grafo completo
+            auto mayor = greater<pair<long long,int>>();
+            esp.g[nodoDesvio] = 0;
+            esp.selloG[nodoDesvio] = esp.sello;
+            esp.previo[nodoDesvio] = -1;
+            esp.monticulo.push_back({(long long)h[nodoDesvio], nodoDesvio});
+            bool llego = false;
+
+            while (!esp.monticulo.empty()) {
+                pop_heap(esp.monticulo.begin(), esp.monticulo.end(), mayor);
+                auto [f, u] = esp.monticulo.back();
+                esp.monticulo.pop_back();
+                if (f > esp.g[u] + (long long)h[u]) continue;
+                if (u == destino) { llego = true; break; }
+
+                for (int a = motor.inicio(u); a < motor.fin(u); ++a) {
+                    int v = motor.destino(a);
+                    if (esp.selloNodo[v] == esp.sello || h[v] == Motor::SIN_CONEXION) continue;
+                    if (esp.selloEnlace[motor.enlaceDeArco(a)] == esp.sello) continue;
+                    long long ng = esp.g[u] + motor.costo(a);
+                    if (esp.selloG[v] != esp.sello || ng < esp.g[v]) {
+                        esp.selloG[v] = esp.sello;
+                        esp.g[v] = ng;
+                        esp.previo[v] = u;
+                        esp.monticulo.push_back({ng + (long long)h[v], v});
+                        push_heap(esp.monticulo.begin(), esp.monticulo.end(), mayor);
+                    }
+                }
+            }
+
+            if (!llego) {
+                res.nodos.clear();
+                return;
+            }
+            size_t raiz = res.nodos.size();
+            for (int v = destino; v != -1; v = esp.previo[v])
+                res.nodos.push_back(v);
+            reverse(res.nodos.begin() + raiz, res.nodos.end());
+            res.costo = costoRaiz[j] + esp.g[destino];
+        });
+
+        for (auto& c : encontrados) {
+            if (c.nodos.empty() || vistos.count(c.nodos)) continue;
+            vistos.insert(c.nodos);
+            candidatos.insert({c.costo, std::move(c.nodos)});
+        }
+        if (candidatos.empty()) break;
+
+        CaminoK siguiente;
+        siguiente.costo = candidatos.begin()->first;
+        siguiente.nodos = candidatos.begin()->second;
+        candidatos.erase(candidatos.begin());
+        aceptados.push_back(std::move(siguiente));
+    }
+
+    return aceptados;
+}
+
+} // namespace
+
+vector<CaminoK> kCaminosMasCortos(const MotorElegido& motor, int origen, int destino,
+                                  int k, int hilos) {
+    return visit([&](const auto& m) { return yen(m, origen, destino, k, hilos); }, motor);
+}
@@ -0,0 +1,25 @@
+#ifndef CAMINOSK_H
+#define CAMINOSK_H
+
+#include "motorrutas.h"
+#include <vector>
+
+struct CaminoK {
+    std::vector<int> nodos;   // índices 0-based del motor, de origen a destino
+    long long costo = 0;
+};
+
+// k caminos simples más cortos entre dos índices (algoritmo de Yen), en orden
+// de costo creciente. Puede devolver menos de k si no hay más caminos.
+// - El árbol de caminos mínimos hacia el destino se calcula una sola vez: da
+//   el primer camino, sirve de heurística exacta para A* en cada desvío y,
+//   si el camino del árbol desde el nodo de desvío no toca nada prohibido,
+//   se usa directamente sin buscar.
+// - Los nodos/enlaces prohibidos se marcan con sellos en búferes por hilo que
+//   se reutilizan entre desvíos (no se copia ni modifica el grafo).
+// - Los desvíos de un mismo camino son independientes y se calculan en
+//   paralelo.
+std::vector<CaminoK> kCaminosMasCortos(const MotorElegido& motor, int origen, int destino,
+                                       int k, int hilos = 0);
+
+#endif // CAMINOSK_H
@@ -0,0 +1,201 @@
+#include "catalogo.h"
+#include "red.h"
+#include "diario.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char* ARCHIVO_CATALOGO = "catalogo.txt";
+
+// Número N de "red_N.txt", o -1 si el nombre no tiene esa forma
+static int numeroDeRed(const string& nombre) {
+    if (nombre.size() < 9 || nombre.compare(0, 4, "red_") != 0 ||
+        nombre.compare(nombre.size() - 4, 4, ".txt") != 0)
+        return -1;
+    string medio = nombre.substr(4, nombre.size() - 8);
+    if (medio.empty() || !all_of(medio.begin(), medio.end(), ::isdigit)) return -1;
+    return stoi(medio);
+}
+
+static bool estadoArchivo(const string& ruta, uintmax_t& bytes, long long& modificado) {
+    error_code ec;
+    bytes = fs::file_size(ruta, ec);
+    if (ec) return false;
+    auto fecha = fs::last_write_time(ruta, ec);
+    if (ec) return false;
+    modificado = (long long)fecha.time_since_epoch().count();
+    return true;
+}
+
+static uintmax_t tamanoDiario(const string& rutaBase) {
+    error_code ec;
+    uintmax_t bytes = fs::file_size(DiarioCambios::rutaDiario(rutaBase), ec);
+    return ec ? 0 : bytes;
+}
+
+// ============================
+// Construcción y consultas
+// ============================
+Catalogo::Catalogo(const string& carpeta) : directorio(carpeta) {
+    error_code ec;
+    fs::create_directories(directorio, ec);
+    leerArchivoCatalogo();
+    sincronizar();
+}
+
+string Catalogo::rutaDe(const string& nombre) const {
+    return (fs::path(directorio) / nombre).string();
+}
+
+const EntradaCatalogo* Catalogo::buscar(const string& nombre) const {
+    for (auto& e : lista)
+        if (e.nombre == nombre) return &e;
+    return nullptr;
+}
+
+int Catalogo::siguienteNumero() const {
+    int mayor = 0;
+    for (auto& e : lista) mayor = max(mayor, numeroDeRed(e.nombre));
+    return mayor + 1;
+}
+
+void Catalogo::ordenar() {
+    sort(lista.begin(), lista.end(), [](const EntradaCatalogo& a, const EntradaCatalogo& b) {
+        return numeroDeRed(a.nombre) < numeroDeRed(b.nombre);
+    });
+}
+
+// ============================
+// Sincronización con la carpeta
+// ============================
+bool Catalogo::vigente(const EntradaCatalogo& e) const {
+    uintmax_t bytes;
+    long long modificado;
+    string ruta = rutaDe(e.nombre);
+    return estadoArchivo(ruta, bytes, modificado) && bytes == e.bytes &&
+           modificado == e.modificado && tamanoDiario(ruta) == e.bytesDiario;
+}
+
+// Lee el archivo base: cuenta enlaces y enrutadores distintos y calcula el CRC.
+// No aplica el diario; registrar() deja los conteos exactos al guardar.
+bool Catalogo::escanear(EntradaCatalogo& e) const {
+    string ruta = rutaDe(e.nombre);
+    if (!estadoArchivo(ruta, e.bytes, e.modificado) || !crc32Archivo(ruta, e.crc)) return false;
+    e.bytesDiario = tamanoDiario(ruta);
+    e.formato = e.bytesDiario > 0 ? "enlaces+diario" : "enlaces";
+
+    ifstream in(ruta);
+    string a, b;
+    int costo;
+    vector<bool> visto;
+    e.enrutadores = 0;
+    e.enlaces = 0;
+    while (in >> a >> b >> costo) {
+        if (a.size() < 2 || b.size() < 2) continue;
+        int ids[2] = {atoi(a.c_str() + 1), atoi(b.c_str() + 1)};
+        if (ids[0] == ids[1] || ids[0] <= 0 || ids[1] <= 0) continue;
+        ++e.enlaces;
+        for (int id : ids) {
+            if (id >= (int)visto.size()) visto.resize(id + 1, false);
+            if (!visto[id]) { visto[id] = true; ++e.enrutadores; }
+        }
+    }
+    return true;
+}
+
+void Catalogo::sincronizar() {
+    vector<EntradaCatalogo> nueva;
+    bool cambios = false;
+    error_code ec;
+    for (auto& item : fs::directory_iterator(directorio, ec)) {
+        string nombre = item.path().filename().string();
+        if (!item.is_regular_file() || numeroDeRed(nombre) < 0) continue;
+
+        const EntradaCatalogo* previa = buscar(nombre);
+        if (previa && vigente(*previa)) {
+            nueva.push_back(*previa);
+            continue;
+        }
+        EntradaCatalogo e;
+        e.nombre = nombre;
+        if (escanear(e)) nueva.push_back(e);
+        cambios = true;
+    }
+    if (nueva.size() != lista.size()) cambios = true;
+
+    lista.swap(nueva);
+    ordenar();
+    if (cambios) escribirArchivoCatalogo();
+}
+
+void Catalogo::registrar(const string& nombre, const Red& red) {
+    string ruta = rutaDe(nombre);
+    EntradaCatalogo e;
+    e.nombre = nombre;
+    if (!estadoArchivo(ruta, e.bytes, e.modificado)) return;
+    e.bytesDiario = tamanoDiario(ruta);
+    e.formato = e.bytesDiario > 0 ? "enlaces+diario" : "enlaces";
+    e.enrutadores = red.cantidadEnrutadores();
+    e.enlaces = red.cantidadEnlaces();
+
+    // Si el base no cambió (guardado en el diario) se conserva su CRC
+    const EntradaCatalogo* previa = buscar(nombre);
+    if (previa && previa->bytes == e.bytes && previa->modificado == e.modificado)
+        e.crc = previa->crc;
+    else if (!crc32Archivo(ruta, e.crc))
+        return;
+
+    auto it = find_if(lista.begin(), lista.end(), [&](const EntradaCatalogo& x) { return x.nombre == nombre; });
+    if (it != lista.end()) *it = e;
+    else lista.push_back(e);
+    ordenar();
+    escribirArchivoCatalogo();
+}
+
+// ============================
+// Archivo del catálogo
+// ============================
+// Una línea por red, separada por tabuladores:
+// nombre enrutadores enlaces bytes bytesDiario crc formato modificado
+void Catalogo::leerArchivoCatalogo() {
+    ifstream in(rutaDe(ARCHIVO_CATALOGO));
+    string linea;
+    while (getline(in, linea)) {
+        if (linea.empty() || linea[0] == '#') continue;
+        istringstream campos(linea);
+        EntradaCatalogo e;
+        string crcHex;
+        if (!getline(campos, e.nombre, '\t')) continue;
+        if (!(campos >> e.enrutadores >> e.enlaces >> e.bytes >> e.bytesDiario
+                     >> crcHex >> e.formato >> e.modificado))
+            continue;
+        e.crc = (uint32_t)strtoul(crcHex.c_str(), nullptr, 16);
+        if (numeroDeRed(e.nombre) >= 0) lista.push_back(e);
+    }
+    ordenar();
+}
+
+void Catalogo::escribirArchivoCatalogo() const {
+    string ruta = rutaDe(ARCHIVO_CATALOGO);
+    string temporal = ruta + ".tmp";
+    {
+        ofstream out(temporal, ios::trunc);
+        if (!out.is_open()) return;
+        out << "# nombre\tenrutadores\tenlaces\tbytes\tbytesDiario\tcrc\tformato\tmodificado\n";
+        for (auto& e : lista) {
+            char crc[16];
+            snprintf(crc, sizeof(crc), "%08x", e.crc);
+            out << e.nombre << '\t' << e.enrutadores << '\t' << e.enlaces << '\t' << e.bytes << '\t'
+                << e.bytesDiario << '\t' << crc << '\t' << e.formato << '\t' << e.modificado << '\n';
+        }
+        if (!out.good()) return;
+    }
+    error_code ec;
+    fs::rename(temporal, ruta, ec);
+}
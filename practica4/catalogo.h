@@ -0,0 +1,56 @@
+#ifndef CATALOGO_H
+#define CATALOGO_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Red;
+
+struct EntradaCatalogo {
+    std::string nombre;          // nombre del archivo dentro de la carpeta
+    int enrutadores = 0;
+    int enlaces = 0;
+    uintmax_t bytes = 0;         // tamaño del archivo base
+    uintmax_t bytesDiario = 0;   // tamaño de "<base>.diario" (0 si no hay)
+    uint32_t crc = 0;            // CRC32 del archivo base
+    std::string formato;         // "enlaces" o "enlaces+diario"
+    long long modificado = 0;    // fecha de modificación del base
+};
+
+// ===========================
+// Catálogo de redes guardadas
+// ===========================
+// Guarda en "<carpeta>/catalogo.txt" los metadatos de cada red_N.txt para
+// listarlas sin abrirlas. Una entrada se da por buena mientras el tamaño y
+// la fecha del archivo (y de su diario) no cambien; solo en ese caso se
+// vuelve a leer el archivo. La carpeta se recorre al construir el catálogo
+// y cuando se pide sincronizar(); listar no toca el disco.
+class Catalogo {
+public:
+    explicit Catalogo(const std::string& carpeta);
+
+    const std::string& carpeta() const { return directorio; }
+    std::string rutaDe(const std::string& nombre) const;
+
+    // Entradas ordenadas por número de red (red_1, red_2, ...)
+    const std::vector<EntradaCatalogo>& entradas() const { return lista; }
+    const EntradaCatalogo* buscar(const std::string& nombre) const;
+    int siguienteNumero() const;   // N para un nuevo red_N.txt
+
+    void sincronizar();
+    // Actualiza la entrada tras guardar 'red' en "<carpeta>/<nombre>"
+    void registrar(const std::string& nombre, const Red& red);
+
+private:
+    std::string directorio;
+    std::vector<EntradaCatalogo> lista;
+
+    bool vigente(const EntradaCatalogo& e) const;
+    bool escanear(EntradaCatalogo& e) const;
+    void leerArchivoCatalogo();
+    void escribirArchivoCatalogo() const;
+    void ordenar();
+};
+
+#endif // CATALOGO_H
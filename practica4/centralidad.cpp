@@ -0,0 +1,126 @@
+#include "centralidad.h"
+#include "paralelo.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+using namespace std;
+
+// ============================
+// Resultados
+// ============================
+double ResultadoCentralidad::normalizada(int v) const {
+    double n = (double)nodos.size();
+    if (n < 3) return 0;
+    return nodos[v] / ((n - 1) * (n - 2) / 2);
+}
+
+static vector<int> ordenarDescendente(const vector<double>& valores) {
+    vector<int> indices(valores.size());
+    iota(indices.begin(), indices.end(), 0);
+    stable_sort(indices.begin(), indices.end(), [&](int a, int b) {
+        return valores[a] > valores[b];
+    });
+    return indices;
+}
+
+vector<int> ResultadoCentralidad::nodosOrdenados() const {
+    return ordenarDescendente(nodos);
+}
+
+vector<int> ResultadoCentralidad::enlacesOrdenados() const {
+    return ordenarDescendente(enlaces);
+}
+
+int muestrasParaError(int cantidadNodos, double epsilon, double confianza) {
+    if (cantidadNodos < 3 || epsilon <= 0 || confianza <= 0 || confianza >= 1) return cantidadNodos;
+    double n = cantidadNodos;
+    double escala = n / (n - 1);
+    double k = escala * escala * log(2 * n / (1 - confianza)) / (2 * epsilon * epsilon);
+    return (int)min(n, ceil(k));
+}
+
+// ============================
+// Brandes
+// ============================
+template <class Motor>
+static ResultadoCentralidad brandes(const Motor& motor, int muestras, double confianza,
+                                    int hilos, unsigned semilla) {
+    using Costo = typename Motor::TipoCosto;
+    int n = motor.cantidadNodos();
+    int m = motor.cantidadEnlaces();
+    ResultadoCentralidad resultado;
+    resultado.nodos.assign(n, 0.0);
+    resultado.enlaces.assign(m, 0.0);
+    if (n == 0) return resultado;
+
+    vector<int> fuentes(n);
+    iota(fuentes.begin(), fuentes.end(), 0);
+    if (muestras > 0 && muestras < n) {
+        mt19937 rng(semilla);
+        shuffle(fuentes.begin(), fuentes.end(), rng);
+        fuentes.resize(muestras);
+        resultado.aproximado = true;
+    }
+    resultado.fuentes = (int)fuentes.size();
+
+    struct PorHilo {
+        ArbolCaminos<Costo> arbol;
+        vector<double> dependencia;
+        vector<double> nodos;
+        vector<double> enlaces;
+    };
+    vector<PorHilo> locales(hilosAUsar(hilos, (int)fuentes.size()));
+
+    paraCadaEnParalelo((int)fuentes.size(), hilos, [&](int i, int h) {
+        int s = fuentes[i];
+        PorHilo& local = locales[h];
+        if (local.nodos.empty()) {
+            local.dependencia.assign(n, 0.0);
+            local.nodos.assign(n, 0.0);
+            local.enlaces.assign(m, 0.0);
+        }
+
+        ArbolCaminos<Costo>& a = local.arbol;
+        motor.arbolCaminos(s, a);
+
+        // Acumulación de dependencias desde los nodos más lejanos
+        for (int idx = (int)a.orden.size() - 1; idx >= 0; --idx) {
+            int w = a.orden[idx];
+            double factor = 1.0 + local.dependencia[w];
+            for (int k = motor.inicio(w); k < motor.fin(w); ++k) {
+                int v = motor.destino(k);
+                if (!a.predecesor(v, w, motor.costo(k))) continue;
+                double c = a.fraccion(v, w) * factor;
+                local.enlaces[motor.enlaceDeArco(k)] += c;
+                local.dependencia[v] += c;
+            }
+            if (w != s) local.nodos[w] += local.dependencia[w];
+        }
+        for (int w : a.orden) local.dependencia[w] = 0.0;
+    });
+
+    // Cada par no ordenado se contó desde sus dos extremos
+    double escala = 0.5 * (double)n / (double)resultado.fuentes;
+    for (auto& local : locales) {
+        for (int v = 0; v < (int)local.nodos.size(); ++v)
+            resultado.nodos[v] += local.nodos[v] * escala;
+        for (int e = 0; e < (int)local.enlaces.size(); ++e)
+            resultado.enlaces[e] += local.enlaces[e] * escala;
+    }
+
+    if (resultado.aproximado && n >= 3 && confianza > 0 && confianza < 1) {
+        // dependencia/(n-2) está en [0,1] para cada origen muestreado
+        double k = resultado.fuentes;
+        resultado.confianza = confianza;
+        resultado.errorMaximo = (double)n / (n - 1) * sqrt(log(2.0 * n / (1 - confianza)) / (2 * k));
+    }
+    return resultado;
+}
+
+ResultadoCentralidad calcularIntermediacion(const MotorElegido& motor, int muestras,
+                                            double confianza, int hilos, unsigned semilla) {
+    return visit([&](const auto& m) {
+        return brandes(m, muestras, confianza, hilos, semilla);
+    }, motor);
+}
@@ -0,0 +1,35 @@
+#ifndef CENTRALIDAD_H
+#define CENTRALIDAD_H
+
+#include "motorrutas.h"
+#include <vector>
+
+struct ResultadoCentralidad {
+    std::vector<double> nodos;     // intermediación por nodo (pares no ordenados)
+    std::vector<double> enlaces;   // intermediación por enlace del motor
+    int fuentes = 0;               // orígenes procesados
+    bool aproximado = false;
+    // Solo en modo aproximado: con probabilidad 'confianza', la intermediación
+    // normalizada de TODOS los nodos difiere del valor exacto en menos de esto.
+    double errorMaximo = 0;
+    double confianza = 0;
+
+    // Intermediación de nodo normalizada a [0,1] (dividida por (n-1)(n-2)/2)
+    double normalizada(int v) const;
+    std::vector<int> nodosOrdenados() const;
+    std::vector<int> enlacesOrdenados() const;
+};
+
+// Algoritmo de Brandes para grafos con pesos. Con muestras <= 0 o
+// muestras >= n es exacto; si no, usa 'muestras' orígenes elegidos al azar
+// y escala el resultado por n/muestras. Los orígenes se reparten entre hilos,
+// cada uno con sus propios acumuladores de dependencia.
+ResultadoCentralidad calcularIntermediacion(const MotorElegido& motor, int muestras = 0,
+                                            double confianza = 0.95, int hilos = 0,
+                                            unsigned semilla = 12345u);
+
+// Muestras necesarias para que el error normalizado sea < epsilon en todos
+// los nodos con la confianza dada (Hoeffding + cota de la unión).
+int muestrasParaError(int cantidadNodos, double epsilon, double confianza);
+
+#endif // CENTRALIDAD_H
@@ -0,0 +1,164 @@
+#include "servidor.h"
+#include <iostream>
+#include <sstream>
+#include <random>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+using namespace std;
+
+// ============================
+// Utilidades de conexión
+// ============================
+static int conectarSocket(const string& rutaSocket) {
+    sockaddr_un dir{};
+    if (rutaSocket.size() >= sizeof(dir.sun_path)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    dir.sun_family = AF_UNIX;
+    strncpy(dir.sun_path, rutaSocket.c_str(), sizeof(dir.sun_path) - 1);
+    if (connect(fd, (sockaddr*)&dir, sizeof(dir)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static bool enviarTodo(int fd, const string& datos) {
+    size_t enviado = 0;
+    while (enviado < datos.size()) {
+        ssize_t n = send(fd, datos.data() + enviado, datos.size() - enviado, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        enviado += (size_t)n;
+    }
+    return true;
+}
+
+// Lee una línea completa usando 'buffer' como acumulador entre llamadas
+static bool leerLinea(int fd, string& buffer, string& linea) {
+    char bloque[16384];
+    while (true) {
+        size_t pos = buffer.find('\n');
+        if (pos != string::npos) {
+            linea = buffer.substr(0, pos);
+            buffer.erase(0, pos + 1);
+            return true;
+        }
+        ssize_t n = read(fd, bloque, sizeof(bloque));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buffer.append(bloque, (size_t)n);
+    }
+}
+
+// ============================
+// Cliente interactivo
+// ============================
+int ejecutarCliente(const string& rutaSocket) {
+    int fd = conectarSocket(rutaSocket);
+    if (fd < 0) {
+        cerr << "No se pudo conectar a " << rutaSocket << ": " << strerror(errno) << endl;
+        return 1;
+    }
+
+    cout << "Conectado a " << rutaSocket << ". Comandos: " << COMANDOS_SERVIDOR << "\n";
+    string buffer, linea, respuesta;
+    while (cout << "> " << flush, getline(cin, linea)) {
+        if (linea.empty()) continue;
+        if (!enviarTodo(fd, linea + "\n") || !leerLinea(fd, buffer, respuesta)) {
+            cout << "Conexión cerrada por el servidor.\n";
+            break;
+        }
+        cout << respuesta << "\n";
+        if (linea == "salir" || linea == "apagar") break;
+    }
+
+    close(fd);
+    return 0;
+}
+
+// ============================
+// Generador de carga
+// ============================
+// Cada conexión corre en su propio hilo y mantiene 'profundidad' peticiones
+// en vuelo (pipelining): envía la ventana completa de una sola vez y mide la
+// latencia de cada respuesta desde que se envió su petición.
+int ejecutarGeneradorCarga(const string& rutaSocket, int conexiones,
+                           int peticionesPorConexion, int profundidad) {
+    using Reloj = chrono::steady_clock;
+    if (conexiones <= 0) conexiones = 1;
+    if (profundidad <= 0) profundidad = 1;
+
+    // Preguntar el tamaño de la red para generar IDs válidos
+    int fd = conectarSocket(rutaSocket);
+    if (fd < 0) {
+        cerr << "No se pudo conectar a " << rutaSocket << ": " << strerror(errno) << endl;
+        return 1;
+    }
+    string buffer, respuesta;
+    int n = 0;
+    if (enviarTodo(fd, "info\n") && leerLinea(fd, buffer, respuesta)) {
+        size_t pos = respuesta.find("enrutadores=");
+        if (pos != string::npos) n = stoi(respuesta.substr(pos + 12));
+    }
+    close(fd);
+    if (n <= 0) {
+        cerr << "La red del servidor está vacía.\n";
+        return 1;
+    }
+
+    HistogramaLatencia histograma;
+    atomic<long long> errores{0};
+    vector<thread> hilos;
+
+    auto inicio = Reloj::now();
+    for (int h = 0; h < conexiones; ++h) {
+        hilos.emplace_back([&, h]() {
+            int sock = conectarSocket(rutaSocket);
+            if (sock < 0) { errores += peticionesPorConexion; return; }
+
+            mt19937 rng(12345u + (unsigned)h);
+            uniform_int_distribution<int> id(1, n);
+            deque<Reloj::time_point> enVuelo;
+            string entrada, linea;
+            int enviadas = 0, recibidas = 0;
+
+            while (recibidas < peticionesPorConexion) {
+                string ventana;
+                while (enviadas < peticionesPorConexion && (int)enVuelo.size() < profundidad) {
+                    ventana += (enviadas % 4 == 0 ? "ruta " : "distancia ")
+                               + to_string(id(rng)) + " " + to_string(id(rng)) + "\n";
+                    enVuelo.push_back(Reloj::now());
+                    ++enviadas;
+                }
+                if (!ventana.empty() && !enviarTodo(sock, ventana)) break;
+                if (!leerLinea(sock, entrada, linea)) break;
+
+                auto lat = chrono::duration_cast<chrono::microseconds>(Reloj::now() - enVuelo.front());
+                histograma.registrar((uint64_t)lat.count());
+                enVuelo.pop_front();
+                if (linea.compare(0, 2, "OK") != 0) ++errores;
+                ++recibidas;
+            }
+            errores += peticionesPorConexion - recibidas;
+            enviarTodo(sock, "salir\n");
+            close(sock);
+        });
+    }
+    for (auto& t : hilos) t.join();
+    double segundos = chrono::duration<double>(Reloj::now() - inicio).count();
+
+    uint64_t total = histograma.total();
+    cout << "Peticiones: " << total << " en " << segundos << " s"
+         << " (" << (segundos > 0 ? (long long)(total / segundos) : 0) << " pet/s)\n";
+    cout << "Conexiones: " << conexiones << " | Profundidad: " << profundidad
+         << " | Errores: " << errores.load() << "\n";
+    cout << "Latencia p50: " << histograma.percentil(0.50) << " us"
+         << " | p99: " << histograma.percentil(0.99) << " us\n";
+    return errores.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include "conectividad.h"
+#include <algorithm>
+#include <utility>
+using namespace std;
+
+// ============================
+// Union-find
+// ============================
+void Conectividad::reiniciar(int cantidad) {
+    padre.resize(cantidad);
+    for (int i = 0; i < cantidad; ++i) padre[i] = i;
+    rango.assign(cantidad, 0);
+    cantidadComponentes = cantidad;
+    esValida = true;
+}
+
+void Conectividad::agregarNodo() {
+    padre.push_back((int)padre.size());
+    rango.push_back(0);
+    ++cantidadComponentes;
+}
+
+int Conectividad::raiz(int v) {
+    int r = v;
+    while (padre[r] != r) r = padre[r];
+    while (padre[v] != r) { // compresión de caminos
+        int siguiente = padre[v];
+        padre[v] = r;
+        v = siguiente;
+    }
+    return r;
+}
+
+void Conectividad::unir(int a, int b) {
+    if (a < 0 || b < 0 || a >= (int)padre.size() || b >= (int)padre.size()) return;
+    int ra = raiz(a), rb = raiz(b);
+    if (ra == rb) return;
+    if (rango[ra] < rango[rb]) swap(ra, rb);
+    padre[rb] = ra;
+    if (rango[ra] == rango[rb]) ++rango[ra];
+    --cantidadComponentes;
+}
+
+bool Conectividad::conectados(int a, int b) {
+    if (a < 0 || b < 0 || a >= (int)padre.size() || b >= (int)padre.size()) return false;
+    return raiz(a) == raiz(b);
+}
+
+// ============================
+// Puentes y puntos de articulación
+// ============================
+template <class Motor>
+static PuntosCriticos tarjan(const Motor& motor) {
+    int n = motor.cantidadNodos();
+    PuntosCriticos resultado;
+    vector<int> descubierto(n, -1), bajo(n, 0), enlacePadre(n, -1), siguienteArco(n, 0);
+    vector<char> esArticulacion(n, 0);
+    vector<int> pila;
+    int tiempo = 0;
+
+    for (int raiz = 0; raiz < n; ++raiz) {
+        if (descubierto[raiz] != -1) continue;
+        int hijosRaiz = 0;
+        descubierto[raiz] = bajo[raiz] = tiempo++;
+        siguienteArco[raiz] = motor.inicio(raiz);
+        pila.push_back(raiz);
+
+        while (!pila.empty()) {
+            int u = pila.back();
+            if (siguienteArco[u] < motor.fin(u)) {
+                int k = siguienteArco[u]++;
+                int e = motor.enlaceDeArco(k);
+                if (e == enlacePadre[u]) continue; // no volver por el mismo enlace
+                int v = motor.destino(k);
+                if (descubierto[v] == -1) {
+                    enlacePadre[v] = e;
+                    descubierto[v] = bajo[v] = tiempo++;
+                    siguienteArco[v] = motor.inicio(v);
+                    pila.push_back(v);
+                } else {
+                    bajo[u] = min(bajo[u], descubierto[v]);
+                }
+                continue;
+            }
+
+            // u terminado: propagar al padre
+            pila.pop_back();
+            if (u == raiz) continue;
+            int p = motor.otroExtremo(enlacePadre[u], u);
+            bajo[p] = min(bajo[p], bajo[u]);
+            if (bajo[u] > descubierto[p]) resultado.puentes.push_back(enlacePadre[u]);
+            if (p == raiz) ++hijosRaiz;
+            else if (bajo[u] >= descubierto[p]) esArticulacion[p] = 1;
+        }
+        if (hijosRaiz >= 2) esArticulacion[raiz] = 1;
+    }
+
+    for (int v = 0; v < n; ++v)
+        if (esArticulacion[v]) resultado.articulaciones.push_back(v);
+    sort(resultado.puentes.begin(), resultado.puentes.end());
+    return resultado;
+}
+
+PuntosCriticos buscarPuntosCriticos(const MotorElegido& motor) {
+    return visit([](const auto& m) { return tarjan(m); }, motor);
+}
@@ -0,0 +1,48 @@
+#ifndef CONECTIVIDAD_H
+#define CONECTIVIDAD_H
+
+#include "motorrutas.h"
+#include <vector>
+
+// ===========================
+// Componentes conexas (union-find)
+// ===========================
+// Se actualiza en O(α(n)) al agregar enrutadores o enlaces. Union-find no
+// admite borrados: al quitar un enlace o enrutador el dueño marca la
+// estructura como inválida y la reconstruye (O(E α(n))) en la siguiente
+// consulta, así varios borrados seguidos cuestan una sola reconstrucción.
+// Las consultas comprimen caminos, por lo que no son seguras entre hilos.
+class Conectividad {
+public:
+    void reiniciar(int cantidad);
+    void agregarNodo();
+    void unir(int a, int b);              // índices 0-based
+    bool conectados(int a, int b);
+    int componentes() const { return cantidadComponentes; }
+    int cantidadNodos() const { return (int)padre.size(); }
+
+    bool valida() const { return esValida; }
+    void invalidar() { esValida = false; }
+
+private:
+    std::vector<int> padre;
+    std::vector<int> rango;
+    int cantidadComponentes = 0;
+    bool esValida = true;
+
+    int raiz(int v);
+};
+
+// ===========================
+// Puentes y puntos de articulación
+// ===========================
+struct PuntosCriticos {
+    std::vector<int> puentes;          // índices de enlace del motor
+    std::vector<int> articulaciones;   // índices de nodo, en orden creciente
+};
+
+// Tarjan en O(V + E) con una pila explícita (sin recursión), de modo que
+// funciona en redes muy profundas sin desbordar la pila del programa.
+PuntosCriticos buscarPuntosCriticos(const MotorElegido& motor);
+
+#endif // CONECTIVIDAD_H
@@ -0,0 +1,456 @@
+#include "diario.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+using namespace std;
+namespace fs = std::filesystem;
+
+// ============================
+// CRC32 (polinomio IEEE, por tabla)
+// ============================
+static const uint32_t* tablaCrc() {
+    static uint32_t tabla[256];
+    static bool lista = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            tabla[i] = c;
+        }
+        return true;
+    }();
+    (void)lista;
+    return tabla;
+}
+
+uint32_t crc32(const void* datos, size_t largo, uint32_t previo) {
+    const uint32_t* tabla = tablaCrc();
+    const unsigned char* p = static_cast<const unsigned char*>(datos);
+    uint32_t c = previo ^ 0xFFFFFFFFu;
+    for (size_t i = 0; i < largo; ++i) c = tabla[(c ^ p[i]) & 0xFF] ^ (c >> 8);
+    return c ^ 0xFFFFFFFFu;
+}
+
+bool crc32Archivo(const string& ruta, uint32_t& crc) {
+    ifstream in(ruta, ios::binary);
+    if (!in.is_open()) return false;
+    crc = 0;
+    char bloque[65536];
+    while (in.read(bloque, sizeof(bloque)) || in.gcount() > 0)
+        crc = crc32(bloque, (size_t)in.gcount(), crc);
+    return true;
+}
+
+bool leerLineasConCrc(const string& ruta, uint32_t& crc, const function<void(const string&)>& porLinea) {
+    ifstream in(ruta, ios::binary);
+    if (!in.is_open()) return false;
+    crc = 0;
+    char bloque[65536];
+    string linea;
+    while (in.read(bloque, sizeof(bloque)) || in.gcount() > 0) {
+        size_t leidos = (size_t)in.gcount();
+        crc = crc32(bloque, leidos, crc);
+        size_t inicio = 0;
+        for (size_t i = 0; i < leidos; ++i) {
+            if (bloque[i] != '\n') continue;
+            linea.append(bloque + inicio, i - inicio);
+            porLinea(linea);
+            linea.clear();
+            inicio = i + 1;
+        }
+        linea.append(bloque + inicio, leidos - inicio);
+    }
+    if (!linea.empty()) porLinea(linea);
+    return true;
+}
+
+// ============================
+// Escritura duradera
+// ============================
+static bool sincronizar(const string& ruta, bool directorio = false) {
+    int fd = open(ruta.c_str(), directorio ? (O_RDONLY | O_DIRECTORY) : O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+static void sincronizarCarpeta(const string& ruta) {
+    fs::path carpeta = fs::path(ruta).parent_path();
+    sincronizar(carpeta.empty() ? "." : carpeta.string(), true);
+}
+
+bool reemplazarArchivo(const string& temporal, const string& destino) {
+    error_code ec;
+    fs::rename(temporal, destino, ec);
+    if (ec) return false;
+    sincronizarCarpeta(destino);
+    return true;
+}
+
+// Texto completo a un archivo nuevo, ya en disco al volver
+static bool escribirSincronizado(const string& ruta, const string& texto) {
+    {
+        ofstream out(ruta, ios::binary | ios::trunc);
+        if (!out.is_open()) return false;
+        out << texto;
+        out.flush();
+        if (!out.good()) return false;
+    }
+    return sincronizar(ruta);
+}
+
+bool escribirArchivoBase(const string& ruta, const vector<tuple<int,int,int>>& enlaces, uint32_t& crc) {
+    ofstream archivo(ruta, ios::binary | ios::trunc);
+    if (!archivo.is_open()) return false;
+
+    crc = 0;
+    string bloque;
+    for (auto& [a, b, c] : enlaces) {
+        bloque += "R" + to_string(a) + " R" + to_string(b) + " " + to_string(c) + "\n";
+        if (bloque.size() >= 65536) {
+            crc = crc32(bloque.data(), bloque.size(), crc);
+            archivo << bloque;
+            bloque.clear();
+        }
+    }
+    crc = crc32(bloque.data(), bloque.size(), crc);
+    archivo << bloque;
+    archivo.close();
+    return !archivo.fail() && sincronizar(ruta);
+}
+
+// ============================
+// Bloqueo entre procesos
+// ============================
+BloqueoArchivo::BloqueoArchivo(const string& rutaBase, bool exclusivo) {
+    // El archivo de bloqueo solo se crea junto a un base existente: una ruta
+    // mal escrita no deja "<ruta>.bloqueo" suelto. Sin base no hay nada que
+    // proteger (el primer guardado lo crea con un rename atómico), y sin
+    // permiso para crear el archivo de bloqueo se sigue sin bloquear.
+    string ruta = rutaBase + ".bloqueo";
+    error_code ec;
+    fd = open(ruta.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0 && errno == ENOENT && fs::is_regular_file(rutaBase, ec))
+        fd = open(ruta.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return;
+    while (flock(fd, exclusivo ? LOCK_EX : LOCK_SH) != 0 && errno == EINTR) {}
+}
+
+BloqueoArchivo::~BloqueoArchivo() {
+    if (fd >= 0) close(fd);   // libera el flock
+}
+
+// ============================
+// Formato de registros
+// ============================
+static string cabecera(uint32_t crcBase) {
+    char texto[32];
+    snprintf(texto, sizeof(texto), "#diario %08x\n", crcBase);
+    return texto;
+}
+
+static string formatear(const RegistroCambio& r) {
+    string cuerpo = string(1, r.tipo) + " " + to_string(r.a) + " " + to_string(r.b) + " " + to_string(r.costo);
+    char crc[16];
+    snprintf(crc, sizeof(crc), " %08x\n", crc32(cuerpo.data(), cuerpo.size()));
+    return cuerpo + crc;
+}
+
+static bool interpretar(const string& linea, RegistroCambio& r) {
+    size_t espacio = linea.rfind(' ');
+    if (espacio == string::npos || linea.size() - espacio != 9) return false;
+    uint32_t esperado = (uint32_t)strtoul(linea.c_str() + espacio + 1, nullptr, 16);
+    if (crc32(linea.data(), espacio) != esperado) return false;
+
+    istringstream in(linea.substr(0, espacio));
+    string tipo;
+    if (!(in >> tipo >> r.a >> r.b >> r.costo) || tipo.size() != 1) return false;
+    r.tipo = tipo[0];
+    return r.tipo == 'A' || r.tipo == 'X' || r.tipo == 'E' || r.tipo == 'Q';
+}
+
+static bool leerCabecera(const string& ruta, uint32_t& crc) {
+    ifstream in(ruta, ios::binary);
+    string linea;
+    if (!in.is_open() || !getline(in, linea)) return false;
+    if (linea.compare(0, 8, "#diario ") != 0 || linea.size() != 16) return false;
+    crc = (uint32_t)strtoul(linea.c_str() + 8, nullptr, 16);
+    return true;
+}
+
+// ============================
+// Diario
+// ============================
+DiarioCambios::DiarioCambios(size_t umbralCompactacion) : umbral(umbralCompactacion) {}
+
+DiarioCambios::~DiarioCambios() {
+    esperarCompactacion();
+}
+
+// El archivo de diario que corresponde al base: el ".diario" o, tras un
+// corte entre los dos renombres de la compactación, el ".tmp" nuevo
+static DiarioCambios::Estado ubicarDiario(const string& rutaBase, uint32_t crcBase, string& archivo) {
+    archivo = DiarioCambios::rutaDiario(rutaBase);
+    uint32_t crc;
+    if (leerCabecera(archivo, crc) && crc == crcBase) return DiarioCambios::Estado::Aplicable;
+
+    string temporal = archivo + ".tmp";
+    if (leerCabecera(temporal, crc) && crc == crcBase) {
+        archivo = temporal;
+        return DiarioCambios::Estado::Aplicable;
+    }
+    // Menos que una cabecera completa: el primer agregar se cortó
+    error_code ec;
+    uintmax_t largo = fs::file_size(archivo, ec);
+    return ec || largo < cabecera(0).size() ? DiarioCambios::Estado::Ausente
+                                            : DiarioCambios::Estado::NoCorresponde;
+}
+
+// Registros válidos hasta la primera línea dañada; 'largoValido' son los
+// bytes que ocupan junto con la cabecera
+static void leerRegistros(const string& archivo, vector<RegistroCambio>& cambios,
+                          size_t& descartados, size_t& largoValido) {
+    ifstream in(archivo, ios::binary);
+    string linea;
+    getline(in, linea);
+    largoValido = linea.size() + 1;
+    bool danado = false;
+    while (getline(in, linea)) {
+        RegistroCambio r;
+        if (danado || in.eof() || !interpretar(linea, r)) { // sin '\n' final = escrita a medias
+            danado = true;
+            ++descartados;
+            continue;
+        }
+        cambios.push_back(r);
+        largoValido += linea.size() + 1;
+    }
+}
+
+DiarioCambios::Estado DiarioCambios::leer(const string& rutaBase, uint32_t crcBase,
+                                          vector<RegistroCambio>& cambios, size_t& descartados) {
+    cambios.clear();
+    descartados = 0;
+    string archivo;
+    Estado estado = ubicarDiario(rutaBase, crcBase, archivo);
+    if (estado == Estado::Aplicable) {
+        size_t largoValido;
+        leerRegistros(archivo, cambios, descartados, largoValido);
+    }
+    return estado;
+}
+
+bool DiarioCambios::recuperar(const string& rutaBase, uint32_t crcBase) {
+    string archivo;
+    if (ubicarDiario(rutaBase, crcBase, archivo) != Estado::Aplicable) return true;
+
+    string ruta = rutaDiario(rutaBase);
+    if (archivo != ruta && !reemplazarArchivo(archivo, ruta)) return false;
+
+    vector<RegistroCambio> cambios;
+    size_t descartados = 0, largoValido;
+    leerRegistros(ruta, cambios, descartados, largoValido);
+    if (descartados == 0) return true;
+    error_code ec;
+    fs::resize_file(ruta, largoValido, ec);
+    return !ec && sincronizar(ruta);
+}
+
+bool DiarioCambios::guardarCompleto(const string& rutaBase, const vector<tuple<int,int,int>>& enlaces,
+                                    uint32_t& crc) {
+    BloqueoArchivo bloqueo(rutaBase, true);
+    string ruta = rutaDiario(rutaBase);
+    string baseTemporal = rutaBase + ".tmp";
+    string diarioTemporal = ruta + ".tmp";
+
+    if (!escribirArchivoBase(baseTemporal, enlaces, crc)) {
+        remove(baseTemporal.c_str());
+        return false;
+    }
+    // Si hay diario, antes de tocar el base se deja uno vacío del base nuevo
+    // en ".tmp": un corte después del renombre lo encuentra recuperar()
+    error_code ec;
+    if (fs::exists(ruta, ec) && !escribirSincronizado(diarioTemporal, cabecera(crc))) {
+        remove(baseTemporal.c_str());
+        return false;
+    }
+    if (!reemplazarArchivo(baseTemporal, rutaBase)) {
+        remove(baseTemporal.c_str());
+        remove(diarioTemporal.c_str());
+        return false;
+    }
+    remove(ruta.c_str());             // primero el viejo: el ".tmp" sigue siendo válido
+    remove(diarioTemporal.c_str());
+    sincronizarCarpeta(rutaBase);
+    return true;
+}
+
+void DiarioCambios::asociar(const string& ruta, uint32_t crc) {
+    esperarCompactacion();
+    lock_guard<mutex> lock(mutexDiario);
+    rutaBase = ruta;
+    crcBase = crc;
+    enlazado = true;
+    crearDiario = false;
+
+    string rutaD = rutaDiario(ruta);
+    uint32_t crcDiario;
+    if (leerCabecera(rutaD, crcDiario) && crcDiario == crc) {
+        ifstream in(rutaD, ios::binary);
+        string linea;
+        cantidadRegistros = 0;
+        largoDiario = 0;
+        while (getline(in, linea)) {
+            largoDiario += linea.size() + 1;
+            ++cantidadRegistros;
+        }
+        --cantidadRegistros; // la cabecera
+        return;
+    }
+
+    // Diario ausente o de otro base: se empieza uno nuevo al primer registro
+    crearDiario = true;
+    largoDiario = 0;
+    cantidadRegistros = 0;
+}
+
+void DiarioCambios::desasociar() {
+    esperarCompactacion();
+    lock_guard<mutex> lock(mutexDiario);
+    enlazado = false;
+    rutaBase.clear();
+}
+
+bool DiarioCambios::asociadoA(const string& ruta) const {
+    lock_guard<mutex> lock(mutexDiario);
+    return enlazado && ruta == rutaBase;
+}
+
+DiarioCambios::ResultadoAgregar DiarioCambios::agregar(const vector<RegistroCambio>& cambios) {
+    lock_guard<mutex> lock(mutexDiario);
+    if (!enlazado) return ResultadoAgregar::Fallo;
+
+    string texto = crearDiario ? cabecera(crcBase) : string();
+    for (auto& r : cambios) texto += formatear(r);
+
+    BloqueoArchivo bloqueo(rutaBase, true);
+    // Otro proceso pudo reemplazar el base (guardado completo o compactación)
+    // o escribir en el diario desde que se asoció: agregar a ciegas dejaría
+    // registros que no corresponden al base o un diario sin cabecera
+    string rutaD = rutaDiario(rutaBase);
+    uint32_t crc;
+    if (!crc32Archivo(rutaBase, crc) || crc != crcBase) return ResultadoAgregar::Desfasado;
+    string archivo;
+    Estado estado = ubicarDiario(rutaBase, crcBase, archivo);
+    if (crearDiario) {
+        if (estado != Estado::Ausente) return ResultadoAgregar::Desfasado;
+    } else {
+        error_code ec;
+        if (estado != Estado::Aplicable || archivo != rutaD ||
+            fs::file_size(rutaD, ec) != largoDiario || ec)
+            return ResultadoAgregar::Desfasado;
+    }
+
+    auto modo = ios::binary | (crearDiario ? ios::trunc : ios::app);
+    {
+        ofstream out(rutaD, modo);
+        if (!out.is_open()) return ResultadoAgregar::Fallo;
+        out << texto;
+        out.flush();
+        if (!out.good()) return ResultadoAgregar::Fallo;
+    }
+    if (!sincronizar(rutaD)) return ResultadoAgregar::Fallo;
+
+    crearDiario = false;
+    largoDiario += texto.size();
+    cantidadRegistros += cambios.size();
+    return ResultadoAgregar::Agregado;
+}
+
+size_t DiarioCambios::registros() const {
+    lock_guard<mutex> lock(mutexDiario);
+    return cantidadRegistros;
+}
+
+bool DiarioCambios::debeCompactar() const {
+    lock_guard<mutex> lock(mutexDiario);
+    return enlazado && cantidadRegistros >= umbral && !compactando;
+}
+
+void DiarioCambios::compactarEnSegundoPlano(vector<tuple<int,int,int>> enlaces) {
+    esperarCompactacion();
+    size_t largoInicial;
+    {
+        lock_guard<mutex> lock(mutexDiario);
+        if (!enlazado || crearDiario) return;
+        largoInicial = largoDiario;
+        compactando = true;
+    }
+    compactador = thread(&DiarioCambios::compactar, this, std::move(enlaces), largoInicial);
+}
+
+void DiarioCambios::esperarCompactacion() {
+    if (compactador.joinable()) compactador.join();
+}
+
+void DiarioCambios::compactar(vector<tuple<int,int,int>> enlaces, size_t largoInicial) {
+    reemplazarArchivos(enlaces, largoInicial);
+    lock_guard<mutex> lock(mutexDiario);
+    compactando = false;
+}
+
+void DiarioCambios::reemplazarArchivos(const vector<tuple<int,int,int>>& enlaces, size_t largoInicial) {
+    string base;
+    {
+        lock_guard<mutex> lock(mutexDiario);
+        base = rutaBase;
+    }
+
+    // 1. Base nuevo en un temporal (sin bloquear a quien agrega al diario).
+    //    Otro nombre que el ".tmp" de guardarCompleto, que puede correr en otro proceso.
+    string baseTemporal = base + ".compactando";
+    uint32_t crcNuevo;
+    if (!escribirArchivoBase(baseTemporal, enlaces, crcNuevo)) {
+        remove(baseTemporal.c_str());
+        return;
+    }
+
+    // 2. Diario nuevo = cabecera del base nuevo + registros llegados después.
+    //    Desde aquí nadie lee ni escribe el base o el diario hasta terminar.
+    lock_guard<mutex> lock(mutexDiario);
+    BloqueoArchivo bloqueo(base, true);
+    string rutaD = rutaDiario(base);
+    string cola;
+    {
+        ifstream in(rutaD, ios::binary);
+        in.seekg((streamoff)largoInicial);
+        ostringstream resto;
+        resto << in.rdbuf();
+        cola = resto.str();
+    }
+    string diarioTemporal = rutaD + ".tmp";
+    if (!escribirSincronizado(diarioTemporal, cabecera(crcNuevo) + cola)) {
+        remove(baseTemporal.c_str());
+        remove(diarioTemporal.c_str());
+        return;
+    }
+
+    // 3. Reemplazar base y diario (un corte entre ambos lo recupera recuperar())
+    if (!reemplazarArchivo(baseTemporal, base)) {
+        remove(baseTemporal.c_str());
+        remove(diarioTemporal.c_str());
+        return;
+    }
+    reemplazarArchivo(diarioTemporal, rutaD);
+
+    crcBase = crcNuevo;
+    largoDiario = cabecera(crcNuevo).size() + cola.size();
+    cantidadRegistros = 0;
+    for (char c : cola) if (c == '\n') ++cantidadRegistros;
+}
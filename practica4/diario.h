@@ -0,0 +1,133 @@
+#ifndef DIARIO_H
+#define DIARIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Un cambio registrado en el diario (ids 1..N tal como estaban al hacerlo)
+struct RegistroCambio {
+    char tipo;      // 'A' agregar enrutador, 'X' eliminar enrutador a,
+                    // 'E' enlace a-b con costo (nuevo o recosteado), 'Q' quitar enlace a-b
+    int a = 0;
+    int b = 0;
+    int costo = 0;
+};
+
+uint32_t crc32(const void* datos, std::size_t largo, uint32_t previo = 0);
+bool crc32Archivo(const std::string& ruta, uint32_t& crc);
+
+// Recorre las líneas de 'ruta' y calcula su CRC en la misma lectura, así el
+// CRC corresponde exactamente a lo que se interpretó.
+bool leerLineasConCrc(const std::string& ruta, uint32_t& crc,
+                      const std::function<void(const std::string&)>& porLinea);
+
+// Escribe el archivo base "R<a> R<b> <costo>", lo lleva a disco (fsync) y
+// devuelve su CRC en 'crc'
+bool escribirArchivoBase(const std::string& ruta,
+                         const std::vector<std::tuple<int,int,int>>& enlaces, uint32_t& crc);
+
+// rename() de un temporal ya sincronizado, sincronizando también la carpeta
+bool reemplazarArchivo(const std::string& temporal, const std::string& destino);
+
+// ===========================
+// Bloqueo entre procesos
+// ===========================
+// flock() sobre "<base>.bloqueo": compartido para leer el base y su diario,
+// exclusivo para cambiarlos (agregar, compactar, guardar completo,
+// recuperar al cargar). Así nadie lee un base nuevo con el diario viejo.
+// El "<base>.bloqueo" solo se crea si el base existe.
+class BloqueoArchivo {
+public:
+    BloqueoArchivo(const std::string& rutaBase, bool exclusivo);
+    ~BloqueoArchivo();
+    BloqueoArchivo(const BloqueoArchivo&) = delete;
+    BloqueoArchivo& operator=(const BloqueoArchivo&) = delete;
+
+private:
+    int fd = -1;
+};
+
+// ===========================
+// Diario de cambios
+// ===========================
+// Registro de solo-agregado junto al archivo base ("<base>.diario"). La
+// primera línea es "#diario <crc del base>" y cada cambio es una línea
+// "<tipo> <a> <b> <costo> <crc32>"; al leer, lo que sigue a la primera línea
+// dañada (p. ej. escrita a medias durante un corte) se descarta.
+// La compactación escribe un base nuevo en un hilo aparte y luego reemplaza
+// el diario conservando los registros agregados mientras tanto.
+class DiarioCambios {
+public:
+    explicit DiarioCambios(std::size_t umbralCompactacion = 4096);
+    ~DiarioCambios();
+
+    static std::string rutaDiario(const std::string& rutaBase) { return rutaBase + ".diario"; }
+
+    enum class Estado {
+        Ausente,        // no hay diario (o quedó a medio crear)
+        Aplicable,      // corresponde al base: 'cambios' tiene sus registros
+        NoCorresponde   // es de otro base: aplicarlo daría una red equivocada
+    };
+
+    // Lee los registros válidos del diario de 'rutaBase' si corresponde a un
+    // base con CRC 'crcBase', sin modificar ningún archivo (lo usa también
+    // quien solo compara). En 'descartados' la cantidad de líneas inválidas.
+    // Llamar con el BloqueoArchivo tomado (compartido alcanza).
+    static Estado leer(const std::string& rutaBase, uint32_t crcBase,
+                       std::vector<RegistroCambio>& cambios, std::size_t& descartados);
+
+    // Deja en disco lo que leer() interpretó: renombra el diario de una
+    // compactación cortada y recorta la cola dañada. Solo la Red dueña del
+    // archivo, con el BloqueoArchivo exclusivo.
+    static bool recuperar(const std::string& rutaBase, uint32_t crcBase);
+
+    // Reemplaza el base por 'enlaces' sin ventana en la que un corte deje un
+    // diario viejo apuntando a un base nuevo, y borra el diario. Toma el
+    // bloqueo exclusivo.
+    static bool guardarCompleto(const std::string& rutaBase,
+                                const std::vector<std::tuple<int,int,int>>& enlaces, uint32_t& crc);
+
+    void asociar(const std::string& rutaBase, uint32_t crcBase);
+    void desasociar();
+    bool asociadoA(const std::string& rutaBase) const;
+
+    enum class ResultadoAgregar {
+        Agregado,
+        Desfasado,      // el base o el diario en disco cambiaron desde asociar(): no se escribió
+        Fallo           // error de E/S
+    };
+    // Agrega al diario con el bloqueo exclusivo, solo si el base y el diario
+    // siguen siendo los que se asociaron
+    ResultadoAgregar agregar(const std::vector<RegistroCambio>& cambios);
+    std::size_t registros() const;
+    bool debeCompactar() const;
+
+    // 'enlaces' es una copia del estado que ya incluye todos los registros del diario
+    void compactarEnSegundoPlano(std::vector<std::tuple<int,int,int>> enlaces);
+    void esperarCompactacion();
+
+private:
+    std::size_t umbral;
+    std::string rutaBase;
+    uint32_t crcBase = 0;
+    std::size_t cantidadRegistros = 0;
+    std::size_t largoDiario = 0;    // bytes escritos en el diario
+    bool enlazado = false;
+    bool compactando = false;
+    bool crearDiario = false;       // el archivo se crea con el primer registro
+
+    mutable std::mutex mutexDiario;
+    std::thread compactador;
+
+    void compactar(std::vector<std::tuple<int,int,int>> enlaces, std::size_t largoInicial);
+    void reemplazarArchivos(const std::vector<std::tuple<int,int,int>>& enlaces,
+                            std::size_t largoInicial);
+};
+
+#endif // DIARIO_H
@@ -0,0 +1,380 @@
+#include "diferencias.h"
+#include "diario.h"
+#include "motorrutas.h"
+#include "paralelo.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct EnlaceLeido {
+    int a = 0;
+    int b = 0;
+    int costo = 0;
+    bool quitado = false;   // solo en los cambios del diario
+};
+
+bool antes(const EnlaceLeido& x, const EnlaceLeido& y) {
+    return x.a != y.a ? x.a < y.a : x.b < y.b;
+}
+
+// ============================
+// Lectura en orden de un archivo de enlaces
+// ============================
+// Devuelve los enlaces del archivo base por (idMenor, idMayor) con los
+// cambios del diario ya aplicados. Solo guarda una línea del base y los
+// cambios del diario (que se compactan al superar el umbral).
+class LectorEnlaces {
+public:
+    bool abrir(const string& ruta, string& error);
+    bool siguiente(EnlaceLeido& e);     // false al terminar o ante un error
+    const string& fallo() const { return error; }
+
+private:
+    unique_ptr<BloqueoArchivo> bloqueo;   // el base y el diario no cambian mientras se lee
+    ifstream in;
+    string ruta, linea, error;
+    long long numeroLinea = 0;
+    EnlaceLeido base;
+    EnlaceLeido ultimoBase;
+    bool hayBase = false;
+    bool primero = true;
+    vector<EnlaceLeido> diario;
+    size_t posDiario = 0;
+
+    bool leerBase();
+};
+
+bool LectorEnlaces::abrir(const string& rutaArchivo, string& mensaje) {
+    ruta = rutaArchivo;
+    bloqueo.reset(new BloqueoArchivo(ruta, false));
+    in.open(ruta);
+    if (!in.is_open()) {
+        mensaje = "No se pudo abrir el archivo: " + ruta;
+        return false;
+    }
+
+    error_code ec;
+    uint32_t crc;
+    string rutaDiario = DiarioCambios::rutaDiario(ruta);
+    // El ".tmp" cuenta: puede ser el diario vigente tras una compactación cortada
+    bool hayDiario = fs::exists(rutaDiario, ec) || fs::exists(rutaDiario + ".tmp", ec);
+    if (hayDiario && crc32Archivo(ruta, crc)) {
+        size_t descartados = 0;
+        vector<RegistroCambio> registros;
+        if (DiarioCambios::leer(ruta, crc, registros, descartados) ==
+            DiarioCambios::Estado::NoCorresponde) {
+            mensaje = "El diario de " + ruta + " no corresponde a ese archivo (CRC distinto); "
+                      "no se puede comparar.";
+            return false;
+        }
+        map<pair<int,int>, EnlaceLeido> cambios;
+        for (auto& r : registros) {
+            if (r.tipo == 'A' || r.tipo == 'X') {
+                mensaje = "El diario de " + ruta + " agrega o elimina enrutadores; "
+                          "guarde la red como archivo nuevo antes de compararla.";
+                return false;
+            }
+            EnlaceLeido e{min(r.a, r.b), max(r.a, r.b), r.costo, r.tipo == 'Q'};
+            cambios[{e.a, e.b}] = e;
+        }
+        for (auto& c : cambios) diario.push_back(c.second);
+    }
+
+    hayBase = leerBase();
+    if (!error.empty()) mensaje = error;
+    return error.empty();
+}
+
+bool LectorEnlaces::leerBase() {
+    while (getline(in, linea)) {
+        ++numeroLinea;
+        const char* p = linea.c_str();
+        while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+        if (*p == '\0') continue;
+
+        // "R<a> R<b> <costo>": se salta el prefijo igual que cargarDesdeArchivo
+        char* fin;
+        long a = strtol(p + 1, &fin, 10);
+        bool valida = fin != p + 1;
+        p = fin;
+        while (*p == ' ' || *p == '\t') ++p;
+        long b = valida && *p ? strtol(p + 1, &fin, 10) : 0;
+        valida = valida && fin != p + 1;
+        p = fin;
+        long costo = strtol(p, &fin, 10);
+        if (!valida || fin == p || a <= 0 || b <= 0 || costo < 0) {
+            error = ruta + ": línea " + to_string(numeroLinea) + " inválida";
+            return false;
+        }
+        if (a == b) continue;
+
+        base = {(int)min(a, b), (int)max(a, b), (int)costo};
+        if (!primero && !antes(ultimoBase, base)) {
+            error = ruta + ": los enlaces no están ordenados (línea " + to_string(numeroLinea) +
+                    "); guarde la red como archivo nuevo para ordenarla.";
+            return false;
+        }
+        primero = false;
+        ultimoBase = base;
+        return true;
+    }
+    return false;
+}
+
+bool LectorEnlaces::siguiente(EnlaceLeido& e) {
+    while (error.empty()) {
+        bool hayDiario = posDiario < diario.size();
+        if (!hayBase && !hayDiario) return false;
+
+        if (hayDiario && (!hayBase || !antes(base, diario[posDiario]))) {
+            // El diario reemplaza (o quita) el enlace del base con la misma clave
+            const EnlaceLeido& d = diario[posDiario++];
+            if (hayBase && !antes(d, base)) hayBase = leerBase();
+            if (d.quitado) continue;
+            e = d;
+            return true;
+        }
+        e = base;
+        hayBase = leerBase();
+        return true;
+    }
+    return false;
+}
+
+// Escribe el detalle hasta el límite pedido y cuenta lo omitido
+struct Detalle {
+    ostream& out;
+    long long restantes;
+    long long& omitidas;
+
+    template <class... T>
+    void operator()(const T&... partes) {
+        if (restantes == 0) { ++omitidas; return; }
+        if (restantes > 0) --restantes;
+        (out << ... << partes) << '\n';
+    }
+};
+
+void marcar(vector<bool>& presentes, int id) {
+    if (id >= (int)presentes.size()) presentes.resize(max<size_t>(id + 1, presentes.size() * 2), false);
+    presentes[id] = true;
+}
+
+bool presente(const vector<bool>& presentes, int id) {
+    return id < (int)presentes.size() && presentes[id];
+}
+
+struct CambioEnlace {
+    int a, b;          // ids 1..N
+    int costoA;        // -1 si el enlace no existe en A
+    int costoB;        // -1 si el enlace no existe en B
+};
+
+// Distancia sin ruta, común a los dos motores (sean del tipo que sean)
+const long long SIN_RUTA = LLONG_MAX;
+
+template <class Motor>
+long long distanciaComun(typename Motor::TipoCosto d) {
+    return d == Motor::SIN_CONEXION ? SIN_RUTA : (long long)d;
+}
+
+// ¿Puede el cambio alterar el árbol de un origen a distancia du de a y dv de b en A?
+bool afectaOrigen(const CambioEnlace& c, long long du, long long dv) {
+    const long long INF = SIN_RUTA;
+    // El enlace viejo estaba en algún camino mínimo
+    if (c.costoA >= 0 && ((du != INF && du + c.costoA == dv) || (dv != INF && dv + c.costoA == du)))
+        return true;
+    // El enlace nuevo o más barato empata o mejora algún camino
+    if (c.costoB >= 0 && (c.costoA < 0 || c.costoB < c.costoA))
+        return (du != INF && du + c.costoB <= dv) || (dv != INF && dv + c.costoB <= du);
+    return false;
+}
+
+struct EntradaCambiada {
+    int destino;
+    int saltoA;
+    long long costoA;
+    int saltoB;
+    long long costoB;
+};
+
+string describirEntrada(int salto, long long costo) {
+    if (costo == SIN_RUTA) return "sin ruta";
+    return "salto R" + to_string(salto + 1) + " costo " + to_string(costo);
+}
+
+// Recalcula los orígenes afectados por 'cambios' y escribe las entradas de
+// tabla que difieren entre A y B
+template <class Motor>
+void compararTablas(const Motor& motorA, const Motor& motorB, int n,
+                    const vector<CambioEnlace>& cambios, const vector<bool>& enA,
+                    const vector<bool>& enB, const OpcionesDiferencias& opciones,
+                    ResumenDiferencias& resumen, Detalle& escribir) {
+    using Costo = typename Motor::TipoCosto;
+
+    // Orígenes a recalcular: con dist(a, s) y dist(b, s) en A (los enlaces
+    // son bidireccionales) se decide para todos los s a la vez.
+    vector<char> afectado(n, 0);
+    if ((long long)cambios.size() * 2 >= n) {
+        fill(afectado.begin(), afectado.end(), 1);
+    } else {
+        int h = hilosAUsar(opciones.hilos, (int)cambios.size());
+        vector<vector<char>> marcas(h, vector<char>(n, 0));
+        vector<vector<Costo>> du(h), dv(h);
+        vector<vector<int>> previo(h);
+        paraCadaEnParalelo((int)cambios.size(), h, [&](int i, int hilo) {
+            const CambioEnlace& c = cambios[i];
+            motorA.dijkstra(c.a - 1, du[hilo], previo[hilo]);
+            motorA.dijkstra(c.b - 1, dv[hilo], previo[hilo]);
+            for (int s = 0; s < n; ++s)
+                if (afectaOrigen(c, distanciaComun<Motor>(du[hilo][s]),
+                                 distanciaComun<Motor>(dv[hilo][s])))
+                    marcas[hilo][s] = 1;
+        });
+        for (auto& m : marcas)
+            for (int s = 0; s < n; ++s) afectado[s] |= m[s];
+    }
+
+    vector<int> origenes;
+    for (int s = 0; s < n; ++s)
+        if (afectado[s] && presente(enA, s + 1) && presente(enB, s + 1)) origenes.push_back(s);
+    resumen.origenesRecalculados = (int)origenes.size();
+
+    // Por bloques, para escribir en orden sin guardar todos los resultados
+    int h = hilosAUsar(opciones.hilos, (int)origenes.size());
+    const int BLOQUE = 64 * h;
+    struct Busqueda {
+        vector<Costo> dist;
+        vector<int> previo, orden;
+    };
+    vector<Busqueda> busA(h), busB(h);
+    vector<vector<EntradaCambiada>> resultado(BLOQUE);
+
+    for (size_t inicio = 0; inicio < origenes.size(); inicio += BLOQUE) {
+        int cantidad = (int)min<size_t>(BLOQUE, origenes.size() - inicio);
+        paraCadaEnParalelo(cantidad, h, [&](int i, int hilo) {
+            int s = origenes[inicio + i];
+            Busqueda& a = busA[hilo];
+            Busqueda& b = busB[hilo];
+            motorA.dijkstra(s, a.dist, a.previo, &a.orden);
+            motorB.dijkstra(s, b.dist, b.previo, &b.orden);
+            vector<int> saltoA = primerosSaltos(s, a.previo, a.orden);
+            vector<int> saltoB = primerosSaltos(s, b.previo, b.orden);
+
+            resultado[i].clear();
+            for (int d = 0; d < n; ++d)
+                if (d != s && (a.dist[d] != b.dist[d] || saltoA[d] != saltoB[d]))
+                    resultado[i].push_back({d, saltoA[d], distanciaComun<Motor>(a.dist[d]),
+                                            saltoB[d], distanciaComun<Motor>(b.dist[d])});
+        });
+
+        for (int i = 0; i < cantidad; ++i) {
+            int s = origenes[inicio + i];
+            for (auto& e : resultado[i]) {
+                ++resumen.entradasCambiadas;
+                escribir("~ ruta R", s + 1, " -> R", e.destino + 1, ": ",
+                         describirEntrada(e.saltoA, e.costoA), " -> ",
+                         describirEntrada(e.saltoB, e.costoB));
+            }
+        }
+    }
+}
+
+} // namespace
+
+// ============================
+// Comparación
+// ============================
+bool compararArchivosRed(const string& rutaA, const string& rutaB, ostream& detalle,
+                         ResumenDiferencias& resumen, string& error,
+                         const OpcionesDiferencias& opciones) {
+    resumen = ResumenDiferencias();
+    LectorEnlaces la, lb;
+    if (!la.abrir(rutaA, error) || !lb.abrir(rutaB, error)) return false;
+
+    Detalle escribir{detalle, opciones.limiteDetalle, resumen.lineasOmitidas};
+    vector<bool> enA, enB;
+    vector<tuple<int,int,int>> listaA, listaB;   // solo para las tablas
+    vector<CambioEnlace> cambios;
+    int n = 0;                                   // mayor id visto
+
+    // Mezcla de las dos listas ordenadas
+    EnlaceLeido x, y;
+    bool hayA = la.siguiente(x), hayB = lb.siguiente(y);
+    while (hayA || hayB) {
+        bool soloA = hayA && (!hayB || antes(x, y));
+        bool soloB = hayB && (!hayA || antes(y, x));
+        if (soloA) {
+            ++resumen.enlacesQuitados;
+            escribir("- enlace R", x.a, " - R", x.b, " costo ", x.costo);
+            if (opciones.tablas) cambios.push_back({x.a, x.b, x.costo, -1});
+        } else if (soloB) {
+            ++resumen.enlacesAgregados;
+            escribir("+ enlace R", y.a, " - R", y.b, " costo ", y.costo);
+            if (opciones.tablas) cambios.push_back({y.a, y.b, -1, y.costo});
+        } else if (x.costo != y.costo) {
+            ++resumen.enlacesRecosteados;
+            escribir("~ enlace R", x.a, " - R", x.b, " costo ", x.costo, " -> ", y.costo);
+            if (opciones.tablas) cambios.push_back({x.a, x.b, x.costo, y.costo});
+        } else {
+            ++resumen.enlacesIguales;
+        }
+
+        if (!soloB) {
+            marcar(enA, x.a);
+            marcar(enA, x.b);
+            n = max(n, x.b);
+            if (opciones.tablas) listaA.emplace_back(x.a, x.b, x.costo);
+            hayA = la.siguiente(x);
+        }
+        if (!soloA) {
+            marcar(enB, y.a);
+            marcar(enB, y.b);
+            n = max(n, y.b);
+            if (opciones.tablas) listaB.emplace_back(y.a, y.b, y.costo);
+            hayB = lb.siguiente(y);
+        }
+    }
+    if (!la.fallo().empty() || !lb.fallo().empty()) {
+        error = !la.fallo().empty() ? la.fallo() : lb.fallo();
+        return false;
+    }
+
+    for (int id = 1; id <= n; ++id) {
+        bool a = presente(enA, id), b = presente(enB, id);
+        if (a && !b) {
+            ++resumen.enrutadoresQuitados;
+            escribir("- enrutador R", id);
+        } else if (b && !a) {
+            ++resumen.enrutadoresAgregados;
+            escribir("+ enrutador R", id);
+        }
+    }
+    if (!opciones.tablas || cambios.empty()) return true;
+
+    // ============================
+    // Tablas de enrutamiento
+    // ============================
+    // Los dos motores del mismo tipo, elegido para el mayor costo de ambos
+    int costoMayorB = 0;
+    for (auto& e : listaB) costoMayorB = max(costoMayorB, get<2>(e));
+    MotorElegido elegidoA = elegirMotor(n, listaA, costoMayorB);
+    listaA = {};
+    visit([&](const auto& motorA) {
+        decay_t<decltype(motorA)> motorB(n, listaB);
+        listaB = {};
+        compararTablas(motorA, motorB, n, cambios, enA, enB, opciones, resumen, escribir);
+    }, elegidoA);
+    return true;
+}
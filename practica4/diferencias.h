@@ -0,0 +1,53 @@
+#ifndef DIFERENCIAS_H
+#define DIFERENCIAS_H
+
+#include <ostream>
+#include <string>
+
+struct OpcionesDiferencias {
+    bool tablas = false;             // comparar también las tablas de enrutamiento
+    long long limiteDetalle = -1;    // líneas de detalle a escribir (-1 = todas)
+    int hilos = 0;                   // 0 = los del equipo
+};
+
+struct ResumenDiferencias {
+    long long enlacesIguales = 0;
+    long long enlacesAgregados = 0;
+    long long enlacesQuitados = 0;
+    long long enlacesRecosteados = 0;
+    int enrutadoresAgregados = 0;
+    int enrutadoresQuitados = 0;
+    // Solo con OpcionesDiferencias::tablas
+    int origenesRecalculados = 0;
+    long long entradasCambiadas = 0;
+    long long lineasOmitidas = 0;    // detalle que superó el límite
+};
+
+// ===========================
+// Diferencias entre dos redes guardadas
+// ===========================
+// Recorre los dos archivos de enlaces a la vez, como una mezcla de listas
+// ordenadas: guardarEnArchivo los escribe por (idMenor, idMayor), así que
+// basta una pasada y memoria para una línea de cada uno (más un bit por
+// enrutador). Si un archivo tiene diario, sus cambios de enlaces se mezclan
+// sobre la marcha; los diarios que agregan o eliminan enrutadores no se
+// pueden mezclar así y se informa un error.
+//
+// Con 'tablas' se arma un motor por archivo, los dos con el tipo de costo
+// que pide el mayor costo de ambos, y solo se recalculan los
+// orígenes cuyo árbol de caminos mínimos puede cambiar: los que tenían un
+// enlace modificado dentro de algún camino mínimo o a los que un enlace
+// nuevo o abaratado les ofrece un camino igual o mejor.
+//
+// En 'detalle' se escribe una línea por cambio, por ejemplo:
+//   + enlace R1 - R5 costo 7
+//   ~ enlace R1 - R2 costo 5 -> 8
+//   - enrutador R9
+//   ~ ruta R3 -> R8: salto R4 costo 10 -> salto R5 costo 12
+// Devuelve false (con el motivo en 'error') si un archivo no se puede leer
+// o no está ordenado.
+bool compararArchivosRed(const std::string& rutaA, const std::string& rutaB,
+                         std::ostream& detalle, ResumenDiferencias& resumen,
+                         std::string& error, const OpcionesDiferencias& opciones = {});
+
+#endif // DIFERENCIAS_H
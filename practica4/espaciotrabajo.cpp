@@ -0,0 +1,181 @@
+#include "espaciotrabajo.h"
+#include "conectividad.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <utility>
+using namespace std;
+
+// ============================
+// Construcción
+// ============================
+EspacioTrabajo::EspacioTrabajo(Catalogo& catalogo, size_t presupuestoBytes)
+    : catalogo(catalogo), limite(presupuestoBytes) {}
+
+// Aproximación del tamaño de una Red: cada Router con su map de vecinos y
+// su puntero en el vector, y cada enlace como dos nodos de map.
+size_t EspacioTrabajo::estimarBytes(int enrutadores, int enlaces) {
+    const size_t porEnrutador = sizeof(Router) + sizeof(Router*) + 32;
+    const size_t porNodoMapa = sizeof(pair<Router* const, int>) + 48;
+    return (size_t)enrutadores * porEnrutador + (size_t)enlaces * 2 * porNodoMapa;
+}
+
+// ============================
+// Carga perezosa y LRU
+// ============================
+void EspacioTrabajo::tocar(Ranura& r, const string& nombre) {
+    if (r.posicion != recientes.end()) recientes.erase(r.posicion);
+    recientes.push_front(nombre);
+    r.posicion = recientes.begin();
+}
+
+void EspacioTrabajo::liberarEspacio(size_t necesarios) {
+    auto it = recientes.end();
+    while (usados + necesarios > limite && it != recientes.begin()) {
+        --it;
+        auto ranura = redes.find(*it);
+        if (*it == activo || ranura->second.red->tieneCambiosSinGuardar())
+            continue; // no se puede descargar sin perder datos
+
+        cout << "Descargando " << *it << " de memoria (presupuesto excedido).\n";
+        usados -= ranura->second.bytes;
+        redes.erase(ranura);
+        it = recientes.erase(it);
+    }
+    if (usados + necesarios > limite)
+        cout << "Aviso: las redes en uso superan el presupuesto de memoria.\n";
+}
+
+void EspacioTrabajo::adoptar(const string& nombre, Red* red) {
+    auto existente = redes.find(nombre);
+    if (existente != redes.end()) {
+        usados -= existente->second.bytes;
+        recientes.erase(existente->second.posicion);
+        redes.erase(existente);
+    }
+
+    Ranura& r = redes[nombre];
+    r.red.reset(red);
+    r.bytes = estimarBytes(red->cantidadEnrutadores(), red->cantidadEnlaces());
+    r.posicion = recientes.end();
+    usados += r.bytes;
+    tocar(r, nombre);
+    activo = nombre;
+    liberarEspacio(0);
+}
+
+Red* EspacioTrabajo::activar(const string& nombre) {
+    auto existente = redes.find(nombre);
+    if (existente != redes.end()) {
+        tocar(existente->second, nombre);
+        activo = nombre;
+        return existente->second.red.get();
+    }
+
+    string ruta = catalogo.rutaDe(nombre);
+    if (!ifstream(ruta).good()) {
+        cout << "No existe la red " << nombre << ".\n";
+        return nullptr;
+    }
+
+    // Se carga primero en una Red aparte: si falla, el espacio queda como
+    // estaba y la red activa (que main sigue usando) no se toca
+    unique_ptr<Red> red(new Red());
+    if (!red->cargarDesdeArchivo(ruta)) return nullptr;
+
+    // Hacer lugar con la red activa todavía protegida; la nueva aún no está
+    // en 'redes', así que tampoco puede descargarse
+    size_t bytes = estimarBytes(red->cantidadEnrutadores(), red->cantidadEnlaces());
+    liberarEspacio(bytes);
+
+    Ranura& r = redes[nombre];
+    r.red = std::move(red);
+    r.bytes = bytes;
+    r.posicion = recientes.end();
+    usados += r.bytes;
+    tocar(r, nombre);
+    activo = nombre;
+    return r.red.get();
+}
+
+bool EspacioTrabajo::puedeReemplazar(const string& nombre) const {
+    auto it = redes.find(nombre);
+    return it == redes.end() || nombre == activo || !it->second.red->tieneCambiosSinGuardar();
+}
+
+bool EspacioTrabajo::renombrar(const string& anterior, const string& nuevo) {
+    if (anterior == nuevo) return true;
+    auto it = redes.find(anterior);
+    if (it == redes.end()) return true;
+
+    // Una copia cargada del archivo sobrescrito ya no es válida, pero si
+    // tiene cambios sin guardar no se descarta en silencio
+    auto pisada = redes.find(nuevo);
+    if (pisada != redes.end()) {
+        if (pisada->second.red->tieneCambiosSinGuardar()) {
+            cout << "La red " << nuevo << " tiene cambios sin guardar; no se reemplaza.\n";
+            return false;
+        }
+        usados -= pisada->second.bytes;
+        recientes.erase(pisada->second.posicion);
+        redes.erase(pisada);
+    }
+
+    Ranura ranura = std::move(it->second);
+    redes.erase(it);
+    recientes.erase(ranura.posicion);
+    ranura.posicion = recientes.end();
+    Ranura& r = redes[nuevo] = std::move(ranura);
+    tocar(r, nuevo);
+    if (activo == anterior) activo = nuevo;
+    return true;
+}
+
+vector<string> EspacioTrabajo::cargadas() const {
+    return vector<string>(recientes.begin(), recientes.end());
+}
+
+// ============================
+// Comparación
+// ============================
+void EspacioTrabajo::compararRedes(int origen, int destino) const {
+    if (redes.empty()) {
+        cout << "No hay redes cargadas.\n";
+        return;
+    }
+    bool conRuta = origen > 0 && destino > 0;
+
+    cout << "\n========= COMPARACIÓN DE REDES CARGADAS =========\n";
+    cout << left << setw(16) << "Red" << setw(12) << "Routers" << setw(10) << "Enlaces"
+         << setw(13) << "Componentes" << setw(9) << "Puentes" << setw(14) << "Costo prom.";
+    if (conRuta) cout << "R" << origen << "->R" << destino;
+    cout << "\n" << string(conRuta ? 86 : 74, '-') << "\n";
+
+    for (auto& nombre : recientes) {
+        const Red& red = *redes.at(nombre).red;
+        shared_ptr<const MotorElegido> motor = red.motor();
+        PuntosCriticos criticos = buscarPuntosCriticos(*motor);
+
+        visit([&](const auto& grafo) {
+            double suma = 0;
+            for (int e = 0; e < grafo.cantidadEnlaces(); ++e) suma += get<2>(grafo.enlace(e));
+            double promedio = grafo.cantidadEnlaces() ? suma / grafo.cantidadEnlaces() : 0;
+
+            cout << setw(16) << (nombre == activo ? "*" + nombre : nombre)
+                 << setw(12) << red.cantidadEnrutadores() << setw(10) << grafo.cantidadEnlaces()
+                 << setw(13) << red.cantidadComponentes() << setw(9) << criticos.puentes.size()
+                 << setw(14) << fixed << setprecision(2) << promedio << defaultfloat;
+            if (conRuta) {
+                vector<int> ruta;
+                typename decay_t<decltype(grafo)>::TipoCosto costo;
+                if (grafo.rutaMasCorta(origen - 1, destino - 1, ruta, costo)) cout << textoCosto(costo);
+                else cout << "-";
+            }
+        }, *motor);
+        cout << "\n";
+    }
+    cout << "Memoria estimada: " << usados / 1024 << " KB de " << limite / 1024 << " KB"
+         << " (* = red activa)\n";
+    cout << "=================================================\n";
+}
@@ -0,0 +1,64 @@
+#ifndef ESPACIOTRABAJO_H
+#define ESPACIOTRABAJO_H
+
+#include "catalogo.h"
+#include "red.h"
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ===========================
+// Espacio de trabajo
+// ===========================
+// Mantiene varias Red en memoria, cargadas recién cuando se piden. Si la
+// memoria estimada supera el presupuesto se descargan las menos usadas
+// recientemente, salvo la red activa y las que tienen cambios sin guardar.
+class EspacioTrabajo {
+public:
+    EspacioTrabajo(Catalogo& catalogo, std::size_t presupuestoBytes);
+
+    // Toma posesión de una red ya construida (p. ej. una recién generada)
+    void adoptar(const std::string& nombre, Red* red);
+    // Carga la red si hace falta, la marca como activa y la devuelve. Si
+    // falla devuelve nullptr y el espacio (y la red activa) quedan igual.
+    Red* activar(const std::string& nombre);
+    // false si 'nombre' está cargada con cambios sin guardar y no es la activa:
+    // sobrescribir su archivo haría perder esos cambios
+    bool puedeReemplazar(const std::string& nombre) const;
+    // Pasa la red 'anterior' a llamarse 'nuevo' descartando la copia cargada
+    // de 'nuevo'; false (sin cambiar nada) si esa copia tiene cambios sin guardar
+    bool renombrar(const std::string& anterior, const std::string& nuevo);
+
+    const std::string& nombreActivo() const { return activo; }
+    std::vector<std::string> cargadas() const;   // de la más a la menos reciente
+    std::size_t memoriaUsada() const { return usados; }
+    std::size_t presupuesto() const { return limite; }
+
+    // Tabla comparativa de las redes cargadas; si origen y destino son > 0
+    // agrega el costo de la ruta entre ellos en cada red.
+    void compararRedes(int origen = 0, int destino = 0) const;
+
+    static std::size_t estimarBytes(int enrutadores, int enlaces);
+
+private:
+    struct Ranura {
+        std::unique_ptr<Red> red;
+        std::size_t bytes = 0;
+        std::list<std::string>::iterator posicion;
+    };
+
+    Catalogo& catalogo;
+    std::size_t limite;
+    std::size_t usados = 0;
+    std::string activo;
+    std::map<std::string, Ranura> redes;
+    std::list<std::string> recientes;   // frente = más reciente
+
+    void tocar(Ranura& r, const std::string& nombre);
+    void liberarEspacio(std::size_t necesarios);
+};
+
+#endif // ESPACIOTRABAJO_H
@@ -1,8 +1,15 @@
 #include "red.h"
+#include "servidor.h"
+#include "catalogo.h"
+#include "espaciotrabajo.h"
+#include "diferencias.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <limits>
-#include <QDir>
-#include <QFile>
 
 using namespace std;
 
@@ -19,64 +26,57 @@ void mostrarMenu() {
     cout << "7. Guardar red\n";
     cout << "8. Mostrar tablas de enrutamiento\n";
     cout << "9. Salir\n";
+    cout << "10. Simular matriz de tráfico\n";
+    cout << "11. Enrutadores y enlaces críticos (centralidad)\n";
+    cout << "12. Calcular k rutas más cortas\n";
+    cout << "13. Analizar conectividad\n";
+    cout << "14. Cambiar de red (espacio de trabajo)\n";
+    cout << "15. Comparar redes cargadas\n";
+    cout << "16. Diferencias entre dos redes guardadas\n";
     cout << "=========================================\n";
     cout << "Seleccione una opción: ";
 }
 
 /**
- * @brief Cuenta cuántos archivos red_*.txt existen en la carpeta.
+ * @brief Cantidad de redes red_*.txt registradas en el catálogo.
  */
-int contarRedesDisponibles(const string& carpeta) {
-    QDir dir(QString::fromStdString(carpeta));
-
-    if (!dir.exists()) {
-        dir.mkpath(".");
-        return 0;
-    }
-
-    QStringList filtros;
-    filtros << "red_*.txt";
-    dir.setNameFilters(filtros);
-    dir.setFilter(QDir::Files);
-
-    return dir.entryList().size();
+int contarRedesDisponibles(const Catalogo& catalogo) {
+    return (int)catalogo.entradas().size();
 }
 
 /**
- * @brief Lista las redes disponibles en la carpeta.
+ * @brief Lista las redes del catálogo con sus metadatos, sin abrir los archivos.
+ * @param espacio Si se indica, marca las redes que ya están en memoria.
  */
-vector<string> listarRedesDisponibles(const string& carpeta) {
+vector<string> listarRedesDisponibles(const Catalogo& catalogo,
+                                      const EspacioTrabajo* espacio = nullptr) {
     vector<string> archivos;
-    int cantidad = contarRedesDisponibles(carpeta);
-
-    if (cantidad == 0) {
+    if (contarRedesDisponibles(catalogo) == 0) {
         cout << "No hay redes guardadas disponibles.\n";
         return archivos;
     }
 
-    cout << "\nRedes disponibles:\n";
+    vector<string> enMemoria;
+    if (espacio) enMemoria = espacio->cargadas();
 
-    // Listar red_1.txt, red_2.txt, ... red_n.txt
-    QDir dir(QString::fromStdString(carpeta));
-    for (int i = 1; i <= cantidad; ++i) {
-        string nombreArchivo = "red_" + to_string(i) + ".txt";
-        QString rutaCompleta = dir.filePath(QString::fromStdString(nombreArchivo));
-
-        // Verificar si el archivo existe
-        if (QFile::exists(rutaCompleta)) {
-            archivos.push_back(nombreArchivo);
-            cout << "  [" << i << "] " << nombreArchivo << "\n";
-        }
+    cout << "\nRedes disponibles:\n";
+    for (auto& e : catalogo.entradas()) {
+        archivos.push_back(e.nombre);
+        cout << "  [" << archivos.size() << "] " << e.nombre << " - " << e.enrutadores
+             << " enrutadores, " << e.enlaces << " enlaces, "
+             << (e.bytes + e.bytesDiario + 1023) / 1024 << " KB (" << e.formato << ")";
+        if (find(enMemoria.begin(), enMemoria.end(), e.nombre) != enMemoria.end())
+            cout << " [en memoria]";
+        cout << "\n";
     }
-
     return archivos;
 }
 
 /**
  * @brief Solicita al usuario cómo desea guardar la red.
- * @return Ruta completa del archivo donde guardar
+ * @return Nombre del archivo dentro de la carpeta del catálogo ("" si se cancela)
  */
-string solicitarRutaGuardado(const string& carpeta) {
+string solicitarRutaGuardado(const Catalogo& catalogo) {
     cout << "\n¿Cómo desea guardar la red?\n";
     cout << "1. Crear archivo nuevo\n";
     cout << "2. Sobreescribir archivo existente\n";
@@ -86,30 +86,20 @@ string solicitarRutaGuardado(const string& carpeta) {
     cin >> opcion;
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-    QDir dir(QString::fromStdString(carpeta));
-
     if (opcion == 1) {
-        // Crear archivo nuevo con el siguiente número disponible
-        int cantidadActual = contarRedesDisponibles(carpeta);
-        int nuevoNumero = cantidadActual + 1;
-
-        string nombreArchivo = "red_" + to_string(nuevoNumero) + ".txt";
-        QString rutaCompleta = dir.filePath(QString::fromStdString(nombreArchivo));
-
+        // Crear archivo nuevo con el número siguiente al mayor existente
+        string nombreArchivo = "red_" + to_string(catalogo.siguienteNumero()) + ".txt";
         cout << "Nueva red será guardada como: " << nombreArchivo << "\n";
-        return rutaCompleta.toStdString();
+        return nombreArchivo;
 
     } else if (opcion == 2) {
         // Sobreescribir archivo existente
-        vector<string> disponibles = listarRedesDisponibles(carpeta);
+        vector<string> disponibles = listarRedesDisponibles(catalogo);
 
         if (disponibles.empty()) {
             cout << "No hay archivos existentes para sobreescribir.\n";
             cout << "Creando archivo nuevo...\n";
-
-            string nombreArchivo = "red_1.txt";
-            QString rutaCompleta = dir.filePath(QString::fromStdString(nombreArchivo));
-            return rutaCompleta.toStdString();
+            return "red_1.txt";
         }
 
         cout << "Seleccione el número del archivo a sobreescribir: ";
@@ -125,8 +115,7 @@ string solicitarRutaGuardado(const string& carpeta) {
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
             if (confirmar == 's' || confirmar == 'S') {
-                QString rutaCompleta = dir.filePath(QString::fromStdString(disponibles[eleccion - 1]));
-                return rutaCompleta.toStdString();
+                return disponibles[eleccion - 1];
             } else {
                 cout << "Operación cancelada.\n";
                 return "";
@@ -141,10 +130,143 @@ string solicitarRutaGuardado(const string& carpeta) {
     }
 }
 
+/**
+ * @brief Guarda la red activa, actualiza su entrada del catálogo y su nombre
+ *        en el espacio de trabajo.
+ */
+bool guardarRedActiva(Red& red, Catalogo& catalogo, EspacioTrabajo& espacio) {
+    string nombre = solicitarRutaGuardado(catalogo);
+    if (nombre.empty()) return false;
+    if (!espacio.puedeReemplazar(nombre)) {
+        cout << "La red " << nombre << " está cargada con cambios sin guardar. "
+             << "Actívela y guárdela antes de sobrescribirla.\n";
+        return false;
+    }
+    red.guardarEnArchivo(catalogo.rutaDe(nombre));
+    catalogo.registrar(nombre, red);
+    espacio.renombrar(espacio.nombreActivo(), nombre);
+    return true;
+}
+
+/**
+ * @brief Compara dos archivos de red y muestra el resumen. El detalle va a
+ *        'archivoSalida' o, si está vacío, a la pantalla (hasta 200 líneas).
+ */
+bool mostrarDiferencias(const string& rutaA, const string& rutaB, bool tablas,
+                        const string& archivoSalida) {
+    OpcionesDiferencias opciones;
+    opciones.tablas = tablas;
+    ofstream salida;
+    if (!archivoSalida.empty()) {
+        salida.open(archivoSalida, ios::trunc);
+        if (!salida.is_open()) {
+            cerr << "No se pudo crear el archivo: " << archivoSalida << endl;
+            return false;
+        }
+    } else {
+        opciones.limiteDetalle = 200;
+    }
+
+    cout << "\n========= DIFERENCIAS: " << rutaA << " -> " << rutaB << " =========\n";
+    ResumenDiferencias r;
+    string error;
+    if (!compararArchivosRed(rutaA, rutaB, archivoSalida.empty() ? cout : salida, r, error, opciones)) {
+        cerr << error << endl;
+        return false;
+    }
+    if (r.lineasOmitidas > 0)
+        cout << "... (" << r.lineasOmitidas << " líneas más)\n";
+
+    cout << "\nEnlaces: +" << r.enlacesAgregados << " -" << r.enlacesQuitados
+         << " ~" << r.enlacesRecosteados << " (iguales: " << r.enlacesIguales << ")\n";
+    cout << "Enrutadores: +" << r.enrutadoresAgregados << " -" << r.enrutadoresQuitados << "\n";
+    if (tablas)
+        cout << "Tablas de enrutamiento: " << r.entradasCambiadas << " entradas cambiadas ("
+             << r.origenesRecalculados << " orígenes recalculados)\n";
+    if (!archivoSalida.empty())
+        cout << "Detalle guardado en: " << archivoSalida << "\n";
+    return true;
+}
+
+// Entero de la línea de comandos: todo el texto debe ser un número >= minimo
+static bool argumentoEntero(const string& texto, int minimo, int& valor) {
+    char* fin;
+    errno = 0;
+    long v = strtol(texto.c_str(), &fin, 10);
+    if (texto.empty() || *fin != '\0' || errno == ERANGE || v < minimo || v > INT_MAX) return false;
+    valor = (int)v;
+    return true;
+}
+
+/**
+ * @brief Atiende los modos no interactivos:
+ *   --servidor <archivo> [socket] [hilos]
+ *   --cliente [socket]
+ *   --carga [socket] [conexiones] [peticiones] [profundidad]
+ *   --diferencias <archivoA> <archivoB> [tablas] [salida]
+ * @return Código de salida, o -1 si no se pidió ningún modo.
+ */
+int ejecutarModoLineaComandos(int argc, char *argv[]) {
+    if (argc < 2) return -1;
+
+    string modo = argv[1];
+    auto arg = [&](int i, const string& porDefecto) {
+        return i < argc ? string(argv[i]) : porDefecto;
+    };
+    const string socketPorDefecto = "/tmp/practica4.sock";
+
+    if (modo == "--servidor") {
+        if (argc < 3) {
+            cerr << "Uso: " << argv[0] << " --servidor <archivo> [socket] [hilos]\n";
+            return 1;
+        }
+        int hilos;
+        if (!argumentoEntero(arg(4, "0"), 0, hilos)) {
+            cerr << "Uso: " << argv[0] << " --servidor <archivo> [socket] [hilos]\n"
+                 << "  hilos: entero >= 0 (0 = los del equipo)\n";
+            return 1;
+        }
+        Red red;
+        if (!red.cargarDesdeArchivo(argv[2])) return 1;
+        ServidorConsultas servidor(red, arg(3, socketPorDefecto), hilos, argv[2]);
+        return servidor.ejecutar() ? 0 : 1;
+    }
+    if (modo == "--cliente")
+        return ejecutarCliente(arg(2, socketPorDefecto));
+    if (modo == "--carga") {
+        int conexiones, peticiones, profundidad;
+        if (!argumentoEntero(arg(3, "4"), 1, conexiones) ||
+            !argumentoEntero(arg(4, "10000"), 1, peticiones) ||
+            !argumentoEntero(arg(5, "32"), 1, profundidad)) {
+            cerr << "Uso: " << argv[0] << " --carga [socket] [conexiones] [peticiones] [profundidad]\n"
+                 << "  conexiones, peticiones y profundidad: enteros >= 1\n";
+            return 1;
+        }
+        return ejecutarGeneradorCarga(arg(2, socketPorDefecto), conexiones, peticiones, profundidad);
+    }
+
+    if (modo == "--diferencias") {
+        if (argc < 4) {
+            cerr << "Uso: " << argv[0] << " --diferencias <archivoA> <archivoB> [tablas] [salida]\n";
+            return 1;
+        }
+        return mostrarDiferencias(argv[2], argv[3], arg(4, "") == "tablas", arg(5, "")) ? 0 : 1;
+    }
+
+    cerr << "Modo desconocido: " << modo << "\n";
+    return 1;
+}
+
 int main(int argc, char *argv[]) {
-    Red* red = new Red();
-    string carpeta = "Datos";
-    string nombreArchivo;
+    int codigo = ejecutarModoLineaComandos(argc, argv);
+    if (codigo >= 0) return codigo;
+
+    // Presupuesto de memoria para las redes abiertas a la vez
+    const size_t PRESUPUESTO_MEMORIA = size_t(512) << 20;
+
+    Catalogo catalogo("Datos");
+    EspacioTrabajo espacio(catalogo, PRESUPUESTO_MEMORIA);
+    Red* red = nullptr;
 
     // ======================================================
     // Cargar red existente o crear una nueva
@@ -155,22 +277,19 @@ int main(int argc, char *argv[]) {
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
     if (opcion == 'c' || opcion == 'C') {
-        vector<string> disponibles = listarRedesDisponibles(carpeta);
+        vector<string> disponibles = listarRedesDisponibles(catalogo);
         if (!disponibles.empty()) {
             cout << "Seleccione el número de red a cargar: ";
             int eleccion;
             cin >> eleccion;
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-            if (eleccion > 0 && eleccion <= (int)disponibles.size()) {
-                QDir dir(QString::fromStdString(carpeta));
-                QString rutaCompleta = dir.filePath(QString::fromStdString(disponibles[eleccion - 1]));
-                nombreArchivo = rutaCompleta.toStdString();
-                red->cargarDesdeArchivo(nombreArchivo);
+            if (eleccion > 0 && eleccion <= (int)disponibles.size())
+                red = espacio.activar(disponibles[eleccion - 1]);
+            if (red) {
                 cout << "Red " << eleccion << " cargada correctamente.\n";
             } else {
                 cout << "Opción inválida. Finalizando.\n";
-                delete red;
                 return 0;
             }
         } else {
@@ -185,22 +304,22 @@ int main(int argc, char *argv[]) {
         cin >> cantidad;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-        delete red;
         red = new Red(cantidad);
         red->generarRedAleatoria();
+        espacio.adoptar("(nueva)", red);
 
         cout << "¿Desea guardar esta red? (s/n): ";
         char guardar;
         cin >> guardar;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-        if (guardar == 's' || guardar == 'S') {
-            nombreArchivo = solicitarRutaGuardado(carpeta);
-            if (!nombreArchivo.empty()) {
-                red->guardarEnArchivo(nombreArchivo);
-                cout << "Red guardada exitosamente en: " << nombreArchivo << endl;
-            }
-        }
+        if ((guardar == 's' || guardar == 'S') && guardarRedActiva(*red, catalogo, espacio))
+            cout << "Red guardada exitosamente en: " << catalogo.rutaDe(espacio.nombreActivo()) << endl;
+    }
+
+    if (!red) {
+        red = new Red();
+        espacio.adoptar("(nueva)", red);
     }
 
     // ======================================================
@@ -250,27 +369,126 @@ int main(int argc, char *argv[]) {
         case 6:
             red->eliminarEnlace();
             break;
-        case 7: {
-            string rutaGuardado = solicitarRutaGuardado(carpeta);
-            if (!rutaGuardado.empty()) {
-                red->guardarEnArchivo(rutaGuardado);
-                nombreArchivo = rutaGuardado;
+        case 7:
+            if (guardarRedActiva(*red, catalogo, espacio))
                 cout << "Red guardada exitosamente.\n";
-            }
             break;
-        }
         case 8:
             red->mostrarTablasDeEnrutamiento();
             break;
         case 9:
             cout << "\nSaliendo del programa...\n";
             break;
+        case 10: {
+            string archivoDemandas;
+            int top;
+            char igualCosto;
+            cout << "Ingrese el archivo de demandas (R<origen> R<destino> <volumen>): ";
+            getline(cin, archivoDemandas);
+            cout << "¿Cuántos enlaces más cargados mostrar?: ";
+            cin >> top;
+            cout << "¿Repartir entre caminos de igual costo? (s/n): ";
+            cin >> igualCosto;
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            red->simularTrafico(archivoDemandas, top, igualCosto == 's' || igualCosto == 'S');
+            break;
+        }
+        case 11: {
+            int top;
+            double error;
+            cout << "¿Cuántos enrutadores y enlaces mostrar?: ";
+            cin >> top;
+            cout << "Error máximo para el cálculo aproximado (0 = exacto): ";
+            cin >> error;
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            red->mostrarCentralidad(top, error);
+            break;
+        }
+        case 12: {
+            int o, d, k;
+            char formato;
+            cout << "Ingrese enrutador origen: ";
+            cin >> o;
+            cout << "Ingrese enrutador destino: ";
+            cin >> d;
+            cout << "¿Cuántas rutas?: ";
+            cin >> k;
+            cout << "¿Salida en formato CSV? (s/n): ";
+            cin >> formato;
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            red->calcularKRutas(o, d, k, formato == 's' || formato == 'S');
+            break;
+        }
+        case 13:
+            red->mostrarConectividad();
+            break;
+        case 14: {
+            catalogo.sincronizar(); // solo relee los archivos que cambiaron
+            vector<string> disponibles = listarRedesDisponibles(catalogo, &espacio);
+            // Las redes sin archivo (p. ej. recién generadas) solo viven en memoria
+            for (auto& nombre : espacio.cargadas()) {
+                if (catalogo.buscar(nombre)) continue;
+                disponibles.push_back(nombre);
+                cout << "  [" << disponibles.size() << "] " << nombre << " [en memoria, sin guardar]\n";
+            }
+            if (disponibles.empty()) break;
+
+            int eleccion;
+            cout << "Red activa: " << espacio.nombreActivo() << ". Seleccione la red a usar: ";
+            cin >> eleccion;
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            if (eleccion <= 0 || eleccion > (int)disponibles.size()) {
+                cout << "Opción inválida.\n";
+                break;
+            }
+            if (Red* elegida = espacio.activar(disponibles[eleccion - 1])) {
+                red = elegida;
+                cout << "Red activa: " << espacio.nombreActivo() << "\n";
+            }
+            break;
+        }
+        case 15: {
+            int o, d;
+            cout << "Enrutador origen para comparar rutas (0 = omitir): ";
+            cin >> o;
+            cout << "Enrutador destino (0 = omitir): ";
+            cin >> d;
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            espacio.compararRedes(o, d);
+            break;
+        }
+        case 16: {
+            catalogo.sincronizar();
+            vector<string> disponibles = listarRedesDisponibles(catalogo);
+            if (disponibles.size() < 2) {
+                cout << "Se necesitan al menos dos redes guardadas.\n";
+                break;
+            }
+            int a, b;
+            char tablas;
+            string archivoSalida;
+            cout << "Red anterior: ";
+            cin >> a;
+            cout << "Red nueva: ";
+            cin >> b;
+            cout << "¿Comparar también las tablas de enrutamiento? (s/n): ";
+            cin >> tablas;
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            if (a <= 0 || b <= 0 || a > (int)disponibles.size() || b > (int)disponibles.size()) {
+                cout << "Opción inválida.\n";
+                break;
+            }
+            cout << "Archivo para el detalle (vacío = pantalla): ";
+            getline(cin, archivoSalida);
+            mostrarDiferencias(catalogo.rutaDe(disponibles[a - 1]), catalogo.rutaDe(disponibles[b - 1]),
+                               tablas == 's' || tablas == 'S', archivoSalida);
+            break;
+        }
         default:
             cout << "Opción no válida.\n";
         }
     } while (opcionMenu != 9);
 
-    delete red;
     cout << "Programa finalizado correctamente.\n";
     return 0;
 }
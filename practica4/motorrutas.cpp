@@ -0,0 +1,46 @@
+#include "motorrutas.h"
+#include "red.h"
+using namespace std;
+
+// ============================
+// Primeros saltos
+// ============================
+vector<int> primerosSaltos(int origen, const vector<int>& previo, const vector<int>& orden) {
+    // 'orden' garantiza que previo[v] se procesa antes que v
+    vector<int> salto(previo.size(), -1);
+    for (int v : orden) {
+        if (v == origen) continue;
+        salto[v] = (previo[v] == origen) ? v : salto[previo[v]];
+    }
+    return salto;
+}
+
+// ============================
+// Elección del motor
+// ============================
+template <class Nodo>
+static MotorElegido elegirCosto(int cantidad, const vector<tuple<int,int,int>>& enlaces,
+                                int costoMinimoTipo) {
+    long long mayor = costoMinimoTipo;
+    for (auto& e : enlaces) mayor = max(mayor, (long long)get<2>(e));
+
+    // Camino más caro posible: n - 1 enlaces del costo máximo (cabe en 64 bits)
+    unsigned long long cota = (unsigned long long)mayor * (unsigned long long)max(1, cantidad - 1);
+    if (cota < costoInfinito<uint8_t>())
+        return MotorRutas<uint8_t, Nodo>(cantidad, enlaces);
+    if (cota < costoInfinito<uint16_t>())
+        return MotorRutas<uint16_t, Nodo>(cantidad, enlaces);
+    if (cota < costoInfinito<uint32_t>())
+        return MotorRutas<uint32_t, Nodo>(cantidad, enlaces);
+    return MotorRutas<uint64_t, Nodo>(cantidad, enlaces);
+}
+
+MotorElegido elegirMotor(int cantidad, const vector<tuple<int,int,int>>& enlaces, int costoMinimoTipo) {
+    if (cantidad <= (int)numeric_limits<uint16_t>::max())
+        return elegirCosto<uint16_t>(cantidad, enlaces, costoMinimoTipo);
+    return elegirCosto<uint32_t>(cantidad, enlaces, costoMinimoTipo);
+}
+
+MotorElegido elegirMotor(const Red& red) {
+    return elegirMotor(red.cantidadEnrutadores(), red.obtenerEnlaces());
+}
@@ -0,0 +1,378 @@
+#ifndef MOTORRUTAS_H
+#define MOTORRUTAS_H
+
+#include "paralelo.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+class Red;
+
+// Valor que representa "sin conexión" para cada tipo de costo
+template <class Costo>
+constexpr Costo costoInfinito() {
+    return std::numeric_limits<Costo>::max();
+}
+
+// a + b sin desbordar: el resultado se queda en costoInfinito()
+template <class Costo>
+constexpr Costo sumaSaturada(Costo a, Costo b) {
+    return a > costoInfinito<Costo>() - b ? costoInfinito<Costo>() : Costo(a + b);
+}
+
+// Texto de un costo (uint8_t no sale como carácter)
+template <class Costo>
+std::string textoCosto(Costo c) {
+    return std::to_string((unsigned long long)c);
+}
+
+// Resultado compacto de una consulta muchos-a-muchos: fila i = origen i,
+// columna j = destino j, en orden fila por fila.
+template <class Costo>
+struct TablaDistancias {
+    int filas = 0;
+    int columnas = 0;
+    std::vector<Costo> valores;
+
+    Costo en(int i, int j) const { return valores[(std::size_t)i * columnas + j]; }
+};
+
+// Resultado de una búsqueda desde un origen con todos los caminos mínimos.
+// Los predecesores de v en el DAG de caminos mínimos son los vecinos u con
+// dist[u] + costo(u,v) == dist[v] que se fijaron antes que v; lo segundo solo
+// importa con enlaces de costo 0, donde la igualdad vale en ambos sentidos.
+// La cantidad de caminos crece exponencialmente (en una grilla supera el
+// rango de double), así que se guarda su logaritmo y los repartos se piden
+// con fraccion(), que solo usa la diferencia entre dos nodos.
+template <class Costo>
+struct ArbolCaminos {
+    std::vector<Costo> dist;
+    std::vector<int> arcoPrevio;    // arco u->v usado por Dijkstra, -1 si no hay
+    std::vector<double> logCaminos; // log de la cantidad de caminos mínimos desde el origen
+    std::vector<int> orden;         // nodos alcanzados por distancia creciente
+    std::vector<int> posicion;      // índice de cada nodo en 'orden', -1 si no se alcanzó
+
+    // u es predecesor de v por un arco de costo 'c'
+    bool predecesor(int u, int v, Costo c) const {
+        return posicion[u] >= 0 && posicion[u] < posicion[v] && sumaSaturada(dist[u], c) == dist[v];
+    }
+    // Parte de los caminos mínimos hacia v que llegan por el predecesor u
+    double fraccion(int u, int v) const { return std::exp(logCaminos[u] - logCaminos[v]); }
+};
+
+// log(e^a + e^b) sin pasar por e^a ni e^b
+inline double sumaLogaritmica(double a, double b) {
+    if (a < b) std::swap(a, b);
+    return a + std::log1p(std::exp(b - a));
+}
+
+// ===========================
+// Motor de rutas
+// ===========================
+// Copia compacta (CSR) de la topología de una Red para calcular rutas sin
+// recorrer los map<Router*,int> ni comparar nombres "R<id>".
+// Internamente los nodos son índices 0..n-1 (el índice i corresponde a R<i+1>).
+// Es inmutable una vez construido, así que puede consultarse desde varios hilos.
+//
+// Los índices de nodo se guardan como 'Nodo' y los costos y distancias como
+// 'Costo', del tamaño justo para la red: elegirMotor() toma un tipo en el que
+// entra el camino más largo posible, así que las sumas no desbordan y solo
+// SIN_CONEXION usa el valor máximo. Los costos no pueden ser negativos.
+template <class Costo, class Nodo>
+class MotorRutas {
+public:
+    using TipoCosto = Costo;
+    using TipoNodo = Nodo;
+    static constexpr Costo SIN_CONEXION = costoInfinito<Costo>();
+
+    MotorRutas() : desplazamientos(1, 0) {}
+    // enlaces: (idA, idB, costo) con ids 1..cantidad
+    MotorRutas(int cantidad, const std::vector<std::tuple<int,int,int>>& lista);
+
+    int cantidadNodos() const { return (int)desplazamientos.size() - 1; }
+    int cantidadEnlaces() const { return (int)enlaces.size(); }
+
+    // Acceso a la lista de adyacencia: arcos [inicio(u), fin(u))
+    int inicio(int u) const { return (int)desplazamientos[u]; }
+    int fin(int u) const { return (int)desplazamientos[u + 1]; }
+    int destino(int arco) const { return (int)destinos[arco]; }
+    Costo costo(int arco) const { return costos[arco]; }
+    int enlaceDeArco(int arco) const { return (int)enlaceArco[arco]; }
+    const std::tuple<int,int,int>& enlace(int e) const { return enlaces[e]; }
+    int otroExtremo(int e, int v) const {
+        return std::get<0>(enlaces[e]) == v ? std::get<1>(enlaces[e]) : std::get<0>(enlaces[e]);
+    }
+
+    // Dijkstra desde 'origen'. dist[v] = SIN_CONEXION si v no es alcanzable,
+    // previo[v] = -1 para el origen y los no alcanzables.
+    // Si 'orden' no es nulo, recibe los nodos en el orden en que se fijaron.
+    // Con 'destinoFinal' >= 0 se detiene al fijar ese nodo.
+    void dijkstra(int origen, std::vector<Costo>& dist, std::vector<int>& previo,
+                  std::vector<int>* orden = nullptr, int destinoFinal = -1) const;
+
+    // Dijkstra que además cuenta los caminos mínimos hacia cada nodo.
+    // Reutiliza los vectores de 'arbol' entre llamadas.
+    void arbolCaminos(int origen, ArbolCaminos<Costo>& arbol) const;
+
+    // Ruta más corta entre dos índices (se detiene al fijar el destino).
+    // Devuelve false si no hay ruta.
+    bool rutaMasCorta(int origen, int destino, std::vector<int>& ruta, Costo& costoTotal) const;
+
+    // Distancias de cada origen a cada destino (índices 0-based) sin imprimir.
+    // Como los enlaces son bidireccionales se busca desde el lado más pequeño;
+    // cada búsqueda se detiene al fijar todos los nodos del otro lado y las
+    // búsquedas se reparten entre 'hilos' hilos (0 = los del equipo).
+    TablaDistancias<Costo> tablaDistancias(const std::vector<int>& origenes,
+                                           const std::vector<int>& destinos, int hilos = 0) const;
+
+private:
+    using Entrada = std::pair<Costo, Nodo>;   // (distancia, nodo) en el montículo
+
+    std::vector<std::uint32_t> desplazamientos; // tamaño n+1
+    std::vector<Nodo> destinos;                 // tamaño 2E
+    std::vector<Costo> costos;                  // tamaño 2E
+    std::vector<std::uint32_t> enlaceArco;      // arco -> índice del enlace no dirigido
+    std::vector<std::tuple<int,int,int>> enlaces; // (a, b, costo) con índices 0-based
+};
+
+// Primer salto desde el origen hacia cada nodo (-1 si no hay ruta o es el origen)
+std::vector<int> primerosSaltos(int origen, const std::vector<int>& previo,
+                                const std::vector<int>& orden);
+
+// ===========================
+// Elección del motor
+// ===========================
+// Todas las combinaciones que puede devolver elegirMotor()
+using MotorElegido = std::variant<
+    MotorRutas<std::uint8_t, std::uint16_t>, MotorRutas<std::uint16_t, std::uint16_t>,
+    MotorRutas<std::uint32_t, std::uint16_t>, MotorRutas<std::uint64_t, std::uint16_t>,
+    MotorRutas<std::uint8_t, std::uint32_t>, MotorRutas<std::uint16_t, std::uint32_t>,
+    MotorRutas<std::uint32_t, std::uint32_t>, MotorRutas<std::uint64_t, std::uint32_t>>;
+
+// Arma el motor según lo observado en la red: índices de 16 bits si hay
+// hasta 65535 nodos y el costo más chico en el que entra
+// costoMáximo * (n - 1). 'costoMinimoTipo' fuerza un tipo que admita al
+// menos ese costo (para armar dos motores comparables).
+// Se usa con std::visit y una lambda genérica, que el compilador
+// especializa para cada combinación.
+MotorElegido elegirMotor(int cantidad, const std::vector<std::tuple<int,int,int>>& enlaces,
+                         int costoMinimoTipo = 0);
+MotorElegido elegirMotor(const Red& red);
+
+// ============================
+// Construcción
+// ============================
+template <class Costo, class Nodo>
+MotorRutas<Costo, Nodo>::MotorRutas(int cantidad, const std::vector<std::tuple<int,int,int>>& lista) {
+    if (cantidad < 0) cantidad = 0;
+    desplazamientos.assign((std::size_t)cantidad + 1, 0);
+    enlaces.reserve(lista.size());
+
+    // Contar grados (se ignoran enlaces fuera de rango o bucles)
+    for (auto& [a, b, c] : lista) {
+        if (a <= 0 || b <= 0 || a > cantidad || b > cantidad || a == b) continue;
+        enlaces.emplace_back(a - 1, b - 1, c);
+        ++desplazamientos[a];
+        ++desplazamientos[b];
+    }
+    for (int i = 0; i < cantidad; ++i)
+        desplazamientos[i + 1] += desplazamientos[i];
+
+    destinos.assign(2 * enlaces.size(), 0);
+    costos.assign(2 * enlaces.size(), 0);
+    enlaceArco.assign(2 * enlaces.size(), 0);
+
+    std::vector<std::uint32_t> pos(desplazamientos.begin(), desplazamientos.end() - 1);
+    for (std::uint32_t e = 0; e < enlaces.size(); ++e) {
+        auto [a, b, c] = enlaces[e];
+        std::uint32_t k = pos[a]++;
+        destinos[k] = Nodo(b); costos[k] = Costo(c); enlaceArco[k] = e;
+        k = pos[b]++;
+        destinos[k] = Nodo(a); costos[k] = Costo(c); enlaceArco[k] = e;
+    }
+}
+
+// ============================
+// Dijkstra
+// ============================
+template <class Costo, class Nodo>
+void MotorRutas<Costo, Nodo>::dijkstra(int origen, std::vector<Costo>& dist, std::vector<int>& previo,
+                                       std::vector<int>* orden, int destinoFinal) const {
+    int n = cantidadNodos();
+    dist.assign(n, SIN_CONEXION);
+    previo.assign(n, -1);
+    if (orden) orden->clear();
+    if (origen < 0 || origen >= n) return;
+
+    std::priority_queue<Entrada, std::vector<Entrada>, std::greater<Entrada>> pq;
+    dist[origen] = 0;
+    pq.push({Costo(0), Nodo(origen)});
+
+    while (!pq.empty()) {
+        auto [d, u] = pq.top(); pq.pop();
+        if (d > dist[u]) continue;
+        if (orden) orden->push_back(u);
+        if ((int)u == destinoFinal) break;
+
+        for (std::uint32_t k = desplazamientos[u]; k < desplazamientos[u + 1]; ++k) {
+            Nodo v = destinos[k];
+            Costo nd = sumaSaturada(d, costos[k]);
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                previo[v] = u;
+                pq.push({nd, v});
+            }
+        }
+    }
+}
+
+template <class Costo, class Nodo>
+void MotorRutas<Costo, Nodo>::arbolCaminos(int origen, ArbolCaminos<Costo>& arbol) const {
+    int n = cantidadNodos();
+    arbol.dist.assign(n, SIN_CONEXION);
+    arbol.arcoPrevio.assign(n, -1);
+    arbol.logCaminos.assign(n, 0.0);
+    arbol.posicion.assign(n, -1);
+    arbol.orden.clear();
+    if (origen < 0 || origen >= n) return;
+
+    std::priority_queue<Entrada, std::vector<Entrada>, std::greater<Entrada>> pq;
+    arbol.dist[origen] = 0;
+    pq.push({Costo(0), Nodo(origen)});
+
+    while (!pq.empty()) {
+        auto [d, u] = pq.top(); pq.pop();
+        if (d > arbol.dist[u]) continue;
+        arbol.posicion[u] = (int)arbol.orden.size();
+        arbol.orden.push_back(u);
+
+        for (std::uint32_t k = desplazamientos[u]; k < desplazamientos[u + 1]; ++k) {
+            Nodo v = destinos[k];
+            Costo nd = sumaSaturada(d, costos[k]);
+            if (nd < arbol.dist[v]) {
+                arbol.dist[v] = nd;
+                arbol.arcoPrevio[v] = (int)k;
+                arbol.logCaminos[v] = arbol.logCaminos[u];
+                pq.push({nd, v});
+            } else if (nd == arbol.dist[v] && arbol.posicion[v] < 0) {
+                // otro camino de igual costo (a un nodo fijado solo se llega
+                // así por un enlace de costo 0, y ya no puede sumar caminos)
+                arbol.logCaminos[v] = sumaLogaritmica(arbol.logCaminos[v], arbol.logCaminos[u]);
+            }
+        }
+    }
+}
+
+template <class Costo, class Nodo>
+bool MotorRutas<Costo, Nodo>::rutaMasCorta(int origen, int destino, std::vector<int>& ruta,
+                                           Costo& costoTotal) const {
+    int n = cantidadNodos();
+    ruta.clear();
+    if (origen < 0 || destino < 0 || origen >= n || destino >= n) return false;
+
+    std::vector<Costo> dist;
+    std::vector<int> previo;
+    dijkstra(origen, dist, previo, nullptr, destino);
+    if (dist[destino] == SIN_CONEXION) return false;
+
+    for (int cur = destino; cur != -1; cur = previo[cur])
+        ruta.push_back(cur);
+    std::reverse(ruta.begin(), ruta.end());
+    costoTotal = dist[destino];
+    return true;
+}
+
+// ============================
+// Distancias muchos-a-muchos
+// ============================
+template <class Costo, class Nodo>
+TablaDistancias<Costo> MotorRutas<Costo, Nodo>::tablaDistancias(
+    const std::vector<int>& origenes, const std::vector<int>& destinosConsulta, int hilos) const {
+    int n = cantidadNodos();
+    TablaDistancias<Costo> tabla;
+    tabla.filas = (int)origenes.size();
+    tabla.columnas = (int)destinosConsulta.size();
+    tabla.valores.assign((std::size_t)tabla.filas * tabla.columnas, SIN_CONEXION);
+
+    // Se busca desde el lado con menos nodos: dist(s,t) == dist(t,s)
+    bool invertir = destinosConsulta.size() < origenes.size();
+    const std::vector<int>& raices = invertir ? destinosConsulta : origenes;
+    const std::vector<int>& objetivos = invertir ? origenes : destinosConsulta;
+
+    // Posiciones de cada nodo objetivo (un nodo puede repetirse en la consulta)
+    std::vector<int> primeraPos(n, -1), siguientePos(objetivos.size(), -1);
+    int distintos = 0;
+    for (int j = 0; j < (int)objetivos.size(); ++j) {
+        int v = objetivos[j];
+        if (v < 0 || v >= n) continue;
+        if (primeraPos[v] == -1) ++distintos;
+        siguientePos[j] = primeraPos[v];
+        primeraPos[v] = j;
+    }
+
+    struct Busqueda {
+        std::vector<Costo> dist;
+        std::vector<Nodo> tocados;
+        std::vector<Entrada> monticulo;
+    };
+    std::vector<Busqueda> porHilo(hilosAUsar(hilos, (int)raices.size()));
+
+    paraCadaEnParalelo((int)raices.size(), hilos, [&](int i, int h) {
+        int raiz = raices[i];
+        if (raiz < 0 || raiz >= n || distintos == 0) return;
+
+        Busqueda& b = porHilo[h];
+        if (b.dist.empty()) b.dist.assign(n, SIN_CONEXION);
+        auto mayor = std::greater<Entrada>();
+
+        b.dist[raiz] = 0;
+        b.tocados.push_back(Nodo(raiz));
+        b.monticulo.push_back({Costo(0), Nodo(raiz)});
+        int pendientes = distintos;
+
+        while (!b.monticulo.empty() && pendientes > 0) {
+            std::pop_heap(b.monticulo.begin(), b.monticulo.end(), mayor);
+            auto [d, u] = b.monticulo.back();
+            b.monticulo.pop_back();
+            if (d > b.dist[u]) continue;
+
+            if (primeraPos[u] != -1) {
+                for (int j = primeraPos[u]; j != -1; j = siguientePos[j]) {
+                    std::size_t celda = invertir ? (std::size_t)j * tabla.columnas + i
+                                                 : (std::size_t)i * tabla.columnas + j;
+                    tabla.valores[celda] = d;
+                }
+                --pendientes;
+            }
+
+            for (std::uint32_t k = desplazamientos[u]; k < desplazamientos[u + 1]; ++k) {
+                Nodo v = destinos[k];
+                Costo nd = sumaSaturada(d, costos[k]);
+                if (nd < b.dist[v]) {
+                    if (b.dist[v] == SIN_CONEXION) b.tocados.push_back(v);
+                    b.dist[v] = nd;
+                    b.monticulo.push_back({nd, v});
+                    std::push_heap(b.monticulo.begin(), b.monticulo.end(), mayor);
+                }
+            }
+        }
+
+        // Dejar el búfer listo para la siguiente raíz en O(nodos visitados)
+        for (Nodo v : b.tocados) b.dist[v] = SIN_CONEXION;
+        b.tocados.clear();
+        b.monticulo.clear();
+    });
+
+    return tabla;
+}
+
+#endif // MOTORRUTAS_H
@@ -0,0 +1,40 @@
+#ifndef PARALELO_H
+#define PARALELO_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Número de hilos a usar: 'pedidos' si es positivo, si no los del equipo,
+// nunca más que las tareas disponibles.
+inline int hilosAUsar(int pedidos, int tareas) {
+    int h = pedidos > 0 ? pedidos : (int)std::thread::hardware_concurrency();
+    if (h <= 0) h = 1;
+    return std::max(1, std::min(h, tareas));
+}
+
+// Ejecuta f(i, hilo) para i en [0, cantidad) repartiendo los índices
+// dinámicamente entre 'hilos' hilos. 'hilo' está en [0, hilosAUsar(...)) y
+// sirve para indexar búferes propios de cada hilo.
+template <class F>
+void paraCadaEnParalelo(int cantidad, int hilos, F&& f) {
+    if (cantidad <= 0) return;
+    int h = hilosAUsar(hilos, cantidad);
+    if (h == 1) {
+        for (int i = 0; i < cantidad; ++i) f(i, 0);
+        return;
+    }
+
+    std::atomic<int> siguiente{0};
+    std::vector<std::thread> trabajadores;
+    for (int t = 0; t < h; ++t) {
+        trabajadores.emplace_back([&, t]() {
+            for (int i = siguiente++; i < cantidad; i = siguiente++)
+                f(i, t);
+        });
+    }
+    for (auto& t : trabajadores) t.join();
+}
+
+#endif // PARALELO_H
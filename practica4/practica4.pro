@@ -4,10 +4,32 @@ CONFIG -= app_bundle
 CONFIG += qt
 
 SOURCES += \
+        caminosk.cpp \
+        catalogo.cpp \
+        centralidad.cpp \
+        cliente.cpp \
+        conectividad.cpp \
+        diario.cpp \
+        diferencias.cpp \
         enrutador.cpp \
+        espaciotrabajo.cpp \
         main.cpp \
-        red.cpp
+        motorrutas.cpp \
+        red.cpp \
+        servidor.cpp \
+        trafico.cpp
 
 HEADERS += \
+    caminosk.h \
+    catalogo.h \
+    centralidad.h \
+    conectividad.h \
+    diario.h \
+    diferencias.h \
     enrutador.h \
-    red.h
+    espaciotrabajo.h \
+    motorrutas.h \
+    paralelo.h \
+    red.h \
+    servidor.h \
+    trafico.h
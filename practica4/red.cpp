@@ -2,6 +2,10 @@
 // red.cpp (reemplaza tu archivo actual)
 #include "red.h"
 #include "enrutador.h"
+#include "trafico.h"
+#include "centralidad.h"
+#include "caminosk.h"
+#include "diario.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -11,6 +15,7 @@
 #include <iomanip>
 #include <queue>
 #include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <ctime>
 #include <climits>
@@ -25,6 +30,7 @@ Red::Red() {}
 Red::Red(int cantidad) {
     for (int i = 1; i <= cantidad; ++i)
         enrutadores.push_back(new Router(i));
+    conectividad.reiniciar((int)enrutadores.size());
 }
 
 Red::~Red() {
@@ -51,8 +57,10 @@ void Red::generarRedAleatoria() {
             int costo = (rand() % 20) + 1; // costo entre 1 y 20
             enrutadores[i]->nuevoVecino(enrutadores[j], costo);
             enrutadores[j]->nuevoVecino(enrutadores[i], costo);
+            conectividad.unir(i, j);
         }
     }
+    motorRutas.reset();
 
     cout << "Red aleatoria (completamente conectada) generada correctamente.\n";
 }
@@ -64,67 +72,31 @@ void Red::mostrarRed() const {
         return;
     }
 
-    // Matriz de distancias mínimas
-    vector<vector<int>> distancias(n, vector<int>(n, INT_MAX));
-
-    // Aplicar Dijkstra para cada enrutador como origen
-    for (int i = 0; i < n; ++i) {
-        string origen = enrutadores[i]->getNombre();
-
-        map<string,int> dist;
-        priority_queue<pair<int,string>, vector<pair<int,string>>, greater<pair<int,string>>> pq;
-        for (auto* r : enrutadores) dist[r->getNombre()] = INT_MAX;
-
-        dist[origen] = 0;
-        pq.push({0, origen});
-
-        while (!pq.empty()) {
-            auto [d, actual] = pq.top(); pq.pop();
-            if (d > dist[actual]) continue;
-
-            Router* r_actual = nullptr;
-            for (auto* r : enrutadores)
-                if (r->getNombre() == actual) { r_actual = r; break; }
-            if (!r_actual) continue;
-
-            for (auto& p : r_actual->vecinos) {
-                Router* vecino = p.first;
-                int costo = p.second;
-                string nombreVec = vecino->getNombre();
-                if (dist[actual] + costo < dist[nombreVec]) {
-                    dist[nombreVec] = dist[actual] + costo;
-                    pq.push({dist[nombreVec], nombreVec});
-                }
-            }
-        }
-
-        // Guardar resultados en la matriz
-        for (int j = 0; j < n; ++j) {
-            string destino = enrutadores[j]->getNombre();
-            if (dist[destino] != INT_MAX)
-                distancias[i][j] = dist[destino];
-        }
-    }
-
-    // Mostrar la matriz
     cout << "\n========= MATRIZ DE COSTOS (RUTAS MÁS CORTAS - DIJKSTRA) =========\n";
     cout << setw(5) << " ";
     for (int j = 0; j < n; ++j)
         cout << setw(6) << "R" + to_string(j + 1);
     cout << endl;
 
-    for (int i = 0; i < n; ++i) {
-        cout << setw(4) << "R" + to_string(i + 1);
-        for (int j = 0; j < n; ++j) {
-            if (i == j)
-                cout << setw(6) << "0";
-            else if (distancias[i][j] == INT_MAX)
-                cout << setw(6) << "-";
-            else
-                cout << setw(6) << distancias[i][j];
+    // Un Dijkstra por fila, con el tipo de costo elegido para esta red
+    visit([&](const auto& grafo) {
+        using Motor = decay_t<decltype(grafo)>;
+        vector<typename Motor::TipoCosto> dist;
+        vector<int> previo;
+        for (int i = 0; i < n; ++i) {
+            grafo.dijkstra(i, dist, previo);
+            cout << setw(4) << "R" + to_string(i + 1);
+            for (int j = 0; j < n; ++j) {
+                if (i == j)
+                    cout << setw(6) << "0";
+                else if (dist[j] == Motor::SIN_CONEXION)
+                    cout << setw(6) << "-";
+                else
+                    cout << setw(6) << textoCosto(dist[j]);
+            }
+            cout << endl;
         }
-        cout << endl;
-    }
+    }, *motor());
     cout << "===================================================================\n";
 }
 
@@ -134,37 +106,50 @@ void Red::mostrarRed() const {
 
 // guardarEnArchivo ahora SOLO guarda la red en el archivo que se le pasa
 // en formato de enlaces: "R1 R2 5" por línea (sin duplicados, orden numérico).
+// Si el archivo es el mismo del que se cargó (o al que ya se guardó), solo se
+// agregan los cambios pendientes al diario "<archivo>.diario".
 void Red::guardarEnArchivo(const string& rutaArchivo) const {
-    ofstream archivo(rutaArchivo);
-    if (!archivo.is_open()) {
-        cerr << "Error al abrir/crear archivo: " << rutaArchivo << endl;
-        return;
+    if (diario.asociadoA(rutaArchivo) && ifstream(rutaArchivo).good()) {
+        auto resultado = cambiosPendientes.empty() ? DiarioCambios::ResultadoAgregar::Agregado
+                                                   : diario.agregar(cambiosPendientes);
+        if (resultado == DiarioCambios::ResultadoAgregar::Fallo) {
+            cerr << "Error al escribir el diario de: " << rutaArchivo << endl;
+            return;
+        }
+        if (resultado == DiarioCambios::ResultadoAgregar::Agregado) {
+            size_t agregados = cambiosPendientes.size();
+            cambiosPendientes.clear();
+            enArchivo = true;
+
+            // El base solo puede representar enrutadores con enlaces
+            if (diario.debeCompactar() && sinEnrutadoresAislados())
+                diario.compactarEnSegundoPlano(obtenerEnlaces());
+
+            cout << "Red guardada en: " << rutaArchivo << " (" << agregados
+                 << " cambios agregados al diario)" << endl;
+            return;
+        }
+        // Otro proceso reemplazó el archivo desde que se cargó: los cambios
+        // no aplican sobre ese base, así que se guarda la red completa
+        cout << "El archivo " << rutaArchivo << " cambió desde que se cargó; se guarda completo." << endl;
     }
 
     // Guardamos únicamente enlaces únicos (r->id < vecino->id) en orden numérico
     // para que el archivo sea fácil de cargar.
     // Formato por línea: R<idOrigen> R<idDestino> <costo>
-    // Ordenamos por id para salida consistente.
-    vector<tuple<int,int,int>> enlaces;
-    for (auto* r : enrutadores) {
-        for (auto& p : r->vecinos) {
-            Router* vec = p.first;
-            int costo = p.second;
-            if (r->id < vec->id) {
-                enlaces.emplace_back(r->id, vec->id, costo);
-            }
-        }
-    }
-
-    sort(enlaces.begin(), enlaces.end(), [](const auto& a, const auto& b){
-        if (get<0>(a) != get<0>(b)) return get<0>(a) < get<0>(b);
-        return get<1>(a) < get<1>(b);
-    });
-
-    for (auto& t : enlaces) {
-        archivo << "R" << get<0>(t) << " R" << get<1>(t) << " " << get<2>(t) << "\n";
+    diario.desasociar();
+    uint32_t crc;
+    // Reemplaza el base y borra su diario, que ya queda incluido en él
+    if (!DiarioCambios::guardarCompleto(rutaArchivo, obtenerEnlaces(), crc)) {
+        cerr << "Error al abrir/crear archivo: " << rutaArchivo << endl;
+        return;
     }
-    archivo.close();
+    cambiosPendientes.clear();
+    enArchivo = true;
+    // Con enrutadores aislados el archivo no reproduce los IDs actuales, así
+    // que el próximo guardado vuelve a ser completo
+    if (sinEnrutadoresAislados())
+        diario.asociar(rutaArchivo, crc);
 
     // Además, registramos el nombre en lista_rutas.txt (evita duplicados)
     string lista = "lista_rutas.txt";
@@ -190,36 +175,70 @@ void Red::guardarEnArchivo(const string& rutaArchivo) const {
 }
 
 // Cargar espera líneas con formato: R<num> R<num> <costo>
-void Red::cargarDesdeArchivo(const string& nombreArchivo) {
-    ifstream archivo(nombreArchivo);
-    if (!archivo.is_open()) {
-        cerr << "No se pudo abrir el archivo: " << nombreArchivo << endl;
-        return;
-    }
+// Si falla, la red actual queda como estaba.
+bool Red::cargarDesdeArchivo(const string& nombreArchivo) {
+    // Termina una compactación propia antes de tomar el bloqueo que ella necesita
+    diario.desasociar();
+    // Exclusivo: recuperar() puede reescribir el diario
+    BloqueoArchivo bloqueo(nombreArchivo, true);
 
-    // Limpiar red actual
-    for (auto* r : enrutadores) delete r;
-    enrutadores.clear();
-
-    string a, b;
-    int costo;
     // Usamos un mapa temporal id -> Router*
     map<int, Router*> mapa;
-
-    while (archivo >> a >> b >> costo) {
-        if (a.size() < 2 || b.size() < 2) continue;
+    // El CRC sale de la misma lectura que arma la red: no puede ser de otro base
+    uint32_t crc;
+    int numeroLinea = 0, costoInvalido = 0; // primera línea con costo negativo
+    bool leido = leerLineasConCrc(nombreArchivo, crc, [&](const string& linea) {
+        ++numeroLinea;
+        istringstream campos(linea);
+        string a, b;
+        int costo;
+        if (!(campos >> a >> b >> costo)) return;
+        if (a.size() < 2 || b.size() < 2) return;
         // quitar prefijo 'R' y convertir
         int id1 = stoi(a.substr(1));
         int id2 = stoi(b.substr(1));
-        if (id1 == id2) continue;
+        if (id1 == id2) return;
+        // Dijkstra no admite costos negativos (un enlace negativo en ambos
+        // sentidos ya es un ciclo negativo); el costo 0 sí es válido
+        if (costo < 0) {
+            if (costoInvalido == 0) costoInvalido = numeroLinea;
+            return;
+        }
 
         if (mapa.find(id1) == mapa.end()) mapa[id1] = new Router(id1);
         if (mapa.find(id2) == mapa.end()) mapa[id2] = new Router(id2);
 
         mapa[id1]->nuevoVecino(mapa[id2], costo);
         mapa[id2]->nuevoVecino(mapa[id1], costo);
+    });
+    if (!leido) {
+        for (auto& p : mapa) delete p.second;
+        cerr << "No se pudo abrir el archivo: " << nombreArchivo << endl;
+        return false;
+    }
+    if (costoInvalido > 0) {
+        for (auto& p : mapa) delete p.second;
+        cerr << "ERROR: " << nombreArchivo << ", línea " << costoInvalido
+             << ": el costo de un enlace no puede ser negativo; la red no se cargó." << endl;
+        return false;
+    }
+
+    size_t descartados = 0;
+    vector<RegistroCambio> cambios;
+    if (DiarioCambios::leer(nombreArchivo, crc, cambios, descartados) ==
+        DiarioCambios::Estado::NoCorresponde) {
+        for (auto& p : mapa) delete p.second;
+        cerr << "ERROR: el diario " << DiarioCambios::rutaDiario(nombreArchivo)
+             << " no corresponde a " << nombreArchivo << " (CRC distinto).\n"
+             << "       Sus cambios no se pueden aplicar; la red no se cargó." << endl;
+        return false;
     }
-    archivo.close();
+    if (!DiarioCambios::recuperar(nombreArchivo, crc))
+        cerr << "Aviso: no se pudo reparar el diario de " << nombreArchivo << endl;
+
+    // Limpiar red actual
+    for (auto* r : enrutadores) delete r;
+    enrutadores.clear();
 
     // Insertar routers en vector en orden de id (1..N)
     vector<int> ids;
@@ -232,32 +251,51 @@ void Red::cargarDesdeArchivo(const string& nombreArchivo) {
         enrutadores.push_back(r);
     }
 
-    // IMPORTANTE: los vecinos apuntan a Router* con los ids antiguos;
-    // necesitamos reindexarlos para que sus .id coincidan con la nueva numeración.
-    // Creamos un mapa viejoId -> nuevoPointer
-    map<int, Router*> nuevoMapa;
-    for (auto* r : enrutadores) nuevoMapa[r->id] = r; // ahora r->id es posición, pero vecinos tienen ptrs con old ids
-    // No podemos determinar old ids facilmente desde los punteros si no las actualizamos.
-    // Por simplicidad, asumimos que los archivos vienen con IDs consecutivos 1..N y las referencias por pointer siguen siendo válidas.
-    // Si en tu formato necesitas preservar IDs tal cual, se puede adaptar.
+    conectividad.invalidar(); // se reconstruye en la primera consulta
+    motorRutas.reset();
+    enArchivo = true;
+
+    // Aplicar el diario de cambios
+    cambiosPendientes.clear();
+    reproduciendo = true;
+    for (auto& c : cambios) aplicarCambio(c);
+    reproduciendo = false;
+    diario.asociar(nombreArchivo, crc);
+    if (!cambios.empty())
+        cout << "Cambios aplicados desde el diario: " << cambios.size() << "\n";
+    if (descartados > 0)
+        cout << "Registros dañados descartados del diario: " << descartados << "\n";
 
     cout << "Red cargada desde: " << nombreArchivo << endl;
+    return true;
 }
 
 // ============================
 // Gestión de enrutadores
 // ============================
 void Red::agregarEnrutador() {
-    int nuevoId = enrutadores.size() + 1;
-    enrutadores.push_back(new Router(nuevoId));
-    cout << "Enrutador R" << nuevoId << " agregado.\n";
+    insertarEnrutador();
+    cout << "Enrutador R" << enrutadores.size() << " agregado.\n";
 }
 
 void Red::eliminarEnrutador(int id) {
-    if (id <= 0 || id > (int)enrutadores.size()) {
+    if (!quitarEnrutador(id)) {
         cout << "ID inválido.\n";
         return;
     }
+    cout << "Enrutador R" << id << " eliminado y IDs reajustados.\n";
+}
+
+void Red::insertarEnrutador() {
+    int nuevoId = enrutadores.size() + 1;
+    enrutadores.push_back(new Router(nuevoId));
+    if (conectividad.valida()) conectividad.agregarNodo();
+    registrarCambio({'A'});
+}
+
+bool Red::quitarEnrutador(int id) {
+    if (id <= 0 || id > (int)enrutadores.size())
+        return false;
 
     Router* aEliminar = enrutadores[id - 1];
 
@@ -268,12 +306,37 @@ void Red::eliminarEnrutador(int id) {
 
     delete aEliminar;
     enrutadores.erase(enrutadores.begin() + (id - 1));
+    conectividad.invalidar();
 
     // reajustar ids para que sean consecutivos 1..N
     for (size_t i = 0; i < enrutadores.size(); ++i)
         enrutadores[i]->id = (int)i + 1;
 
-    cout << "Enrutador R" << id << " eliminado y IDs reajustados.\n";
+    registrarCambio({'X', id});
+    return true;
+}
+
+// ============================
+// Diario de cambios
+// ============================
+void Red::registrarCambio(const RegistroCambio& cambio) {
+    motorRutas.reset(); // todo cambio pasa por aquí
+    if (!reproduciendo) cambiosPendientes.push_back(cambio);
+}
+
+void Red::aplicarCambio(const RegistroCambio& cambio) {
+    switch (cambio.tipo) {
+    case 'A': insertarEnrutador(); break;
+    case 'X': quitarEnrutador(cambio.a); break;
+    case 'E': conectar(cambio.a, cambio.b, cambio.costo); break;
+    case 'Q': desconectar(cambio.a, cambio.b); break;
+    }
+}
+
+bool Red::sinEnrutadoresAislados() const {
+    for (auto* r : enrutadores)
+        if (r->vecinos.empty()) return false;
+    return true;
 }
 
 // ============================
@@ -296,12 +359,12 @@ void Red::agregarEnlace() {
         cout << "No se puede conectar un enrutador consigo mismo.\n";
         return;
     }
+    if (costo < 0) {
+        cout << "Costo inválido (no puede ser negativo).\n";
+        return;
+    }
 
-    Router* r1 = enrutadores[id1 - 1];
-    Router* r2 = enrutadores[id2 - 1];
-    r1->nuevoVecino(r2, costo);
-    r2->nuevoVecino(r1, costo);
-
+    conectar(id1, id2, costo);
     cout << "Enlace agregado entre R" << id1 << " y R" << id2 << ".\n";
 }
 
@@ -312,17 +375,143 @@ void Red::eliminarEnlace() {
     cout << "Ingrese el ID del segundo enrutador: ";
     cin >> id2;
 
-    if (id1 <= 0 || id2 <= 0 || id1 > (int)enrutadores.size() || id2 > (int)enrutadores.size()) {
+    if (!desconectar(id1, id2)) {
         cout << "IDs inválidos.\n";
         return;
     }
 
+    cout << "Enlace eliminado entre R" << id1 << " y R" << id2 << ".\n";
+}
+
+bool Red::conectar(int id1, int id2, int costo) {
+    if (id1 <= 0 || id2 <= 0 || id1 > (int)enrutadores.size() || id2 > (int)enrutadores.size())
+        return false;
+    if (id1 == id2 || costo < 0) return false;
+
     Router* r1 = enrutadores[id1 - 1];
     Router* r2 = enrutadores[id2 - 1];
+    r1->nuevoVecino(r2, costo);
+    r2->nuevoVecino(r1, costo);
+    if (conectividad.valida()) conectividad.unir(id1 - 1, id2 - 1);
+    registrarCambio({'E', id1, id2, costo});
+    return true;
+}
+
+bool Red::desconectar(int id1, int id2) {
+    if (id1 <= 0 || id2 <= 0 || id1 > (int)enrutadores.size() || id2 > (int)enrutadores.size())
+        return false;
+
+    Router* r1 = enrutadores[id1 - 1];
+    Router* r2 = enrutadores[id2 - 1];
+    // Sin enlace no hay nada que invalidar ni que registrar en el diario
+    if (r1->vecinos.find(r2) == r1->vecinos.end()) return true;
     r1->eliminarVecino(r2);
     r2->eliminarVecino(r1);
+    conectividad.invalidar();
+    registrarCambio({'Q', id1, id2});
+    return true;
+}
 
-    cout << "Enlace eliminado entre R" << id1 << " y R" << id2 << ".\n";
+// ============================
+// Consultas
+// ============================
+int Red::cantidadEnrutadores() const {
+    return (int)enrutadores.size();
+}
+
+int Red::cantidadEnlaces() const {
+    size_t extremos = 0;
+    for (auto* r : enrutadores) extremos += r->vecinos.size();
+    return (int)(extremos / 2);
+}
+
+bool Red::tieneCambiosSinGuardar() const {
+    return !cambiosPendientes.empty() || (!enArchivo && !enrutadores.empty());
+}
+
+vector<tuple<int,int,int>> Red::obtenerEnlaces() const {
+    vector<tuple<int,int,int>> enlaces;
+    for (auto* r : enrutadores) {
+        for (auto& p : r->vecinos) {
+            Router* vec = p.first;
+            if (r->id < vec->id)
+                enlaces.emplace_back(r->id, vec->id, p.second);
+        }
+    }
+
+    // Ordenamos por id para salida consistente.
+    sort(enlaces.begin(), enlaces.end(), [](const auto& a, const auto& b){
+        if (get<0>(a) != get<0>(b)) return get<0>(a) < get<0>(b);
+        return get<1>(a) < get<1>(b);
+    });
+    return enlaces;
+}
+
+void Red::actualizarConectividad() const {
+    if (conectividad.valida() && conectividad.cantidadNodos() == (int)enrutadores.size())
+        return;
+    conectividad.reiniciar((int)enrutadores.size());
+    for (auto* r : enrutadores)
+        for (auto& p : r->vecinos)
+            if (r->id < p.first->id) conectividad.unir(r->id - 1, p.first->id - 1);
+}
+
+bool Red::estanConectados(int id1, int id2) const {
+    actualizarConectividad();
+    return conectividad.conectados(id1 - 1, id2 - 1);
+}
+
+int Red::cantidadComponentes() const {
+    actualizarConectividad();
+    return conectividad.componentes();
+}
+
+bool Red::esConexa() const {
+    return cantidadComponentes() <= 1;
+}
+
+shared_ptr<const MotorElegido> Red::motor() const {
+    if (!motorRutas) motorRutas = make_shared<const MotorElegido>(elegirMotor(*this));
+    return motorRutas;
+}
+
+// (a, b, costo) del enlace 'e' del motor, con índices 0-based
+static tuple<int,int,int> enlaceDelMotor(const MotorElegido& motor, int e) {
+    return visit([e](const auto& grafo) { return grafo.enlace(e); }, motor);
+}
+
+TablaDistancias<uint64_t> Red::distanciasEntre(const vector<int>& origenes,
+                                               const vector<int>& destinos, int hilos) const {
+    // Pasar de ids 1..N a índices del motor (los inválidos quedan fuera de rango)
+    auto aIndices = [](const vector<int>& ids) {
+        vector<int> indices;
+        indices.reserve(ids.size());
+        for (int id : ids) indices.push_back(id - 1);
+        return indices;
+    };
+    return visit([&](const auto& grafo) {
+        using Motor = decay_t<decltype(grafo)>;
+        auto t = grafo.tablaDistancias(aIndices(origenes), aIndices(destinos), hilos);
+        TablaDistancias<uint64_t> tabla{t.filas, t.columnas, {}};
+        tabla.valores.reserve(t.valores.size());
+        for (auto d : t.valores)
+            tabla.valores.push_back(d == Motor::SIN_CONEXION ? costoInfinito<uint64_t>() : d);
+        return tabla;
+    }, *motor());
+}
+
+// "R1 -> R4 -> R7": camino hasta el índice 'destino' siguiendo 'previo'
+static string textoCamino(const vector<int>& previo, int destino) {
+    vector<int> ruta;
+    for (int v = destino; v != -1; v = previo[v])
+        ruta.push_back(v);
+
+    string camino;
+    for (auto it = ruta.rbegin(); it != ruta.rend(); ++it) {
+        if (it != ruta.rbegin()) camino += " -> ";
+        camino += "R" + to_string(*it + 1);
+    }
+    return camino;
 }
 
 // ============================
@@ -335,128 +524,216 @@ void Red::mostrarTablasDeEnrutamiento() {
     }
 
     cout << "\n========= TABLAS DE ENRUTAMIENTO =========\n";
-    for (auto* origen : enrutadores) {
-        string nombreOrigen = origen->getNombre();
-
-        map<string,int> dist;
-        map<string,string> prev;
-        for (auto* r : enrutadores) dist[r->getNombre()] = INT_MAX;
-        dist[nombreOrigen] = 0;
-
-        priority_queue<pair<int,string>, vector<pair<int,string>>, greater<pair<int,string>>> pq;
-        pq.push({0, nombreOrigen});
-
-        while (!pq.empty()) {
-            auto [d, actual] = pq.top(); pq.pop();
-            if (d > dist[actual]) continue;
-            Router* r_actual = nullptr;
-            for (auto* r : enrutadores) if (r->getNombre() == actual) { r_actual = r; break; }
-            if (!r_actual) continue;
-            for (auto& p : r_actual->vecinos) {
-                Router* vec = p.first;
-                int c = p.second;
-                string nombreVec = "R" + to_string(vec->id);
-                if (dist[actual] + c < dist[nombreVec]) {
-                    dist[nombreVec] = dist[actual] + c;
-                    prev[nombreVec] = actual;
-                    pq.push({dist[nombreVec], nombreVec});
+    visit([&](const auto& grafo) {
+        using Motor = decay_t<decltype(grafo)>;
+        vector<typename Motor::TipoCosto> dist;
+        vector<int> previo;
+        int n = (int)enrutadores.size();
+
+        for (int o = 0; o < n; ++o) {
+            grafo.dijkstra(o, dist, previo);
+            string nombreOrigen = enrutadores[o]->getNombre();
+
+            cout << "Tabla de " << nombreOrigen << ":\n";
+            cout << left << setw(10) << "Destino" << setw(10) << "Costo" << "Camino\n";
+            cout << string(50, '-') << "\n";
+            for (int d = 0; d < n; ++d) {
+                string nombreDest = enrutadores[d]->getNombre();
+                if (d == o) {
+                    cout << setw(10) << nombreDest << setw(10) << 0 << "-" << "\n";
+                    continue;
+                }
+                if (dist[d] == Motor::SIN_CONEXION) {
+                    cout << setw(10) << nombreDest << setw(10) << "-" << "Sin conexión\n";
+                    continue;
                 }
+                cout << setw(10) << nombreDest << setw(10) << textoCosto(dist[d])
+                     << textoCamino(previo, d) << "\n";
             }
+            cout << "\n";
         }
+    }, *motor());
+    cout << "==========================================\n";
+}
 
-        cout << "Tabla de " << nombreOrigen << ":\n";
-        cout << left << setw(10) << "Destino" << setw(10) << "Costo" << "Camino\n";
-        cout << string(50, '-') << "\n";
-        for (auto* destino : enrutadores) {
-            string nombreDest = destino->getNombre();
-            if (nombreDest == nombreOrigen) {
-                cout << setw(10) << nombreDest << setw(10) << 0 << "-" << "\n";
-                continue;
-            }
-            if (dist[nombreDest] == INT_MAX) {
-                cout << setw(10) << nombreDest << setw(10) << "-" << "Sin conexión\n";
-                continue;
-            }
-            // reconstruir camino
-            vector<string> ruta;
-            string cur = nombreDest;
-            while (prev.find(cur) != prev.end()) {
-                ruta.push_back(cur);
-                cur = prev[cur];
-            }
-            ruta.push_back(nombreOrigen);
-            reverse(ruta.begin(), ruta.end());
-            string camino;
-            for (size_t i = 0; i < ruta.size(); ++i) {
-                camino += ruta[i];
-                if (i + 1 < ruta.size()) camino += " -> ";
-            }
-            cout << setw(10) << nombreDest << setw(10) << dist[nombreDest] << camino << "\n";
+// ============================
+// Calcular ruta más corta entre dos enrutadores
+// ============================
+void Red::calcularRutaMasCorta(int origenId, int destinoId) {
+    if (origenId <= 0 || destinoId <= 0 ||
+        origenId > (int)enrutadores.size() || destinoId > (int)enrutadores.size()) {
+        cout << "IDs inválidos.\n";
+        return;
+    }
+
+    string nombreOrigen = enrutadores[origenId - 1]->getNombre();
+    string nombreDestino = enrutadores[destinoId - 1]->getNombre();
+
+    visit([&](const auto& grafo) {
+        using Motor = decay_t<decltype(grafo)>;
+        vector<typename Motor::TipoCosto> dist;
+        vector<int> previo;
+        grafo.dijkstra(origenId - 1, dist, previo, nullptr, destinoId - 1);
+
+        if (dist[destinoId - 1] == Motor::SIN_CONEXION) {
+            cout << "No existe ruta entre " << nombreOrigen << " y " << nombreDestino << ".\n";
+            return;
         }
-        cout << "\n";
+        cout << "Ruta mas corta: " << textoCamino(previo, destinoId - 1)
+             << " | Costo total: " << textoCosto(dist[destinoId - 1]) << "\n";
+    }, *motor());
+}
+
+// ============================
+// Simulación de tráfico
+// ============================
+void Red::simularTrafico(const string& archivoDemandas, int cantidadTop,
+                         bool repartirIgualCosto) const {
+    vector<Demanda> demandas;
+    long long descartadas = 0;
+    if (!leerDemandas(archivoDemandas, cantidadEnrutadores(), demandas, descartadas)) {
+        cerr << "No se pudo abrir el archivo: " << archivoDemandas << endl;
+        return;
+    }
+
+    shared_ptr<const MotorElegido> motor = this->motor();
+    ResultadoTrafico r = ::simularTrafico(*motor, demandas, repartirIgualCosto);
+
+    cout << "\n========= SIMULACIÓN DE TRÁFICO =========\n";
+    cout << "Demandas: " << r.demandas << " (descartadas: " << descartadas << ")\n";
+    cout << "Volumen total: " << r.volumenTotal << " | Sin ruta: " << r.volumenSinRuta << "\n";
+    cout << "Reparto: " << (repartirIgualCosto ? "todos los caminos de igual costo" : "un solo camino") << "\n\n";
+
+    cout << left << setw(16) << "Enlace" << setw(10) << "Costo" << "Carga\n";
+    cout << string(40, '-') << "\n";
+    for (int e : r.masCargados(cantidadTop)) {
+        if (r.cargaEnlace[e] <= 0) break;
+        auto [a, b, c] = enlaceDelMotor(*motor, e);
+        cout << setw(16) << "R" + to_string(a + 1) + " - R" + to_string(b + 1)
+             << setw(10) << c << r.cargaEnlace[e] << "\n";
     }
     cout << "==========================================\n";
 }
 
 // ============================
-// Calcular ruta más corta entre dos enrutadores
+// Centralidad de intermediación
 // ============================
-void Red::calcularRutaMasCorta(int origenId, int destinoId) {
+// errorMaximo <= 0 calcula el valor exacto; si no, muestrea los orígenes
+// necesarios para ese error normalizado con 95% de confianza.
+void Red::mostrarCentralidad(int cantidadTop, double errorMaximo) const {
+    int n = cantidadEnrutadores();
+    if (n == 0) {
+        cout << "No hay enrutadores en la red.\n";
+        return;
+    }
+
+    int muestras = errorMaximo > 0 ? muestrasParaError(n, errorMaximo, 0.95) : 0;
+    shared_ptr<const MotorElegido> motor = this->motor();
+    ResultadoCentralidad r = calcularIntermediacion(*motor, muestras, 0.95);
+
+    cout << "\n========= CENTRALIDAD DE INTERMEDIACIÓN =========\n";
+    if (r.aproximado)
+        cout << "Aproximada con " << r.fuentes << " de " << n << " orígenes"
+             << " | error normalizado < " << r.errorMaximo
+             << " (confianza " << r.confianza * 100 << "%)\n";
+    else
+        cout << "Exacta (" << n << " orígenes)\n";
+
+    int top = min(cantidadTop, n);
+    cout << "\n" << left << setw(10) << "Puesto" << setw(10) << "Router"
+         << setw(16) << "Intermediación" << "Normalizada\n";
+    cout << string(50, '-') << "\n";
+    vector<int> nodos = r.nodosOrdenados();
+    for (int i = 0; i < top; ++i) {
+        int v = nodos[i];
+        cout << setw(10) << i + 1 << setw(10) << "R" + to_string(v + 1)
+             << setw(16) << r.nodos[v] << r.normalizada(v) << "\n";
+    }
+
+    top = min(cantidadTop, (int)r.enlaces.size());
+    cout << "\n" << left << setw(10) << "Puesto" << setw(16) << "Enlace" << "Intermediación\n";
+    cout << string(50, '-') << "\n";
+    vector<int> enlaces = r.enlacesOrdenados();
+    for (int i = 0; i < top; ++i) {
+        int e = enlaces[i];
+        auto [a, b, c] = enlaceDelMotor(*motor, e);
+        cout << setw(10) << i + 1 << setw(16) << "R" + to_string(a + 1) + " - R" + to_string(b + 1)
+             << r.enlaces[e] << "\n";
+    }
+    cout << "=================================================\n";
+}
+
+// ============================
+// k rutas más cortas entre dos enrutadores
+// ============================
+// formatoMaquina imprime "indice,costo,ruta" (ruta con nodos separados por espacio)
+void Red::calcularKRutas(int origenId, int destinoId, int k, bool formatoMaquina) const {
     if (origenId <= 0 || destinoId <= 0 ||
         origenId > (int)enrutadores.size() || destinoId > (int)enrutadores.size()) {
         cout << "IDs inválidos.\n";
         return;
     }
 
-    Router* origen = enrutadores[origenId - 1];
-    Router* destino = enrutadores[destinoId - 1];
-
-    map<string,int> dist;
-    map<string,string> prev;
-    string nombreOrigen = origen->getNombre();
-    string nombreDestino = destino->getNombre();
-
-    for (auto* r : enrutadores) dist[r->getNombre()] = INT_MAX;
-    dist[nombreOrigen] = 0;
-
-    priority_queue<pair<int,string>, vector<pair<int,string>>, greater<pair<int,string>>> pq;
-    pq.push({0, nombreOrigen});
-
-    while (!pq.empty()) {
-        auto [d, actual] = pq.top(); pq.pop();
-        if (d > dist[actual]) continue;
-        Router* r_actual = nullptr;
-        for (auto* r : enrutadores) if (r->getNombre() == actual) { r_actual = r; break; }
-        if (!r_actual) continue;
-        for (auto& p : r_actual->vecinos) {
-            Router* vec = p.first; int c = p.second;
-            string nombreVec = "R" + to_string(vec->id);
-            if (dist[actual] + c < dist[nombreVec]) {
-                dist[nombreVec] = dist[actual] + c;
-                prev[nombreVec] = actual;
-                pq.push({dist[nombreVec], nombreVec});
-            }
+    vector<CaminoK> caminos = kCaminosMasCortos(*motor(), origenId - 1, destinoId - 1, k);
+
+    if (formatoMaquina) {
+        cout << "indice,costo,ruta\n";
+        for (size_t i = 0; i < caminos.size(); ++i) {
+            cout << i + 1 << "," << caminos[i].costo << ",";
+            for (size_t j = 0; j < caminos[i].nodos.size(); ++j)
+                cout << (j ? " " : "") << "R" << caminos[i].nodos[j] + 1;
+            cout << "\n";
         }
+        return;
     }
 
-    if (dist[nombreDestino] == INT_MAX) {
-        cout << "No existe ruta entre " << nombreOrigen << " y " << nombreDestino << ".\n";
+    if (caminos.empty()) {
+        cout << "No existe ruta entre R" << origenId << " y R" << destinoId << ".\n";
         return;
     }
+    for (size_t i = 0; i < caminos.size(); ++i) {
+        cout << "Ruta " << i + 1 << ": ";
+        for (size_t j = 0; j < caminos[i].nodos.size(); ++j) {
+            cout << "R" << caminos[i].nodos[j] + 1;
+            if (j + 1 < caminos[i].nodos.size()) cout << " -> ";
+        }
+        cout << " | Costo total: " << caminos[i].costo << "\n";
+    }
+    if ((int)caminos.size() < k)
+        cout << "Solo existen " << caminos.size() << " rutas simples entre R"
+             << origenId << " y R" << destinoId << ".\n";
+}
 
-    vector<string> ruta;
-    string cur = nombreDestino;
-    while (prev.find(cur) != prev.end()) {
-        ruta.push_back(cur);
-        cur = prev[cur];
+// ============================
+// Conectividad
+// ============================
+void Red::mostrarConectividad() const {
+    if (enrutadores.empty()) {
+        cout << "No hay enrutadores en la red.\n";
+        return;
     }
-    ruta.push_back(nombreOrigen);
-    reverse(ruta.begin(), ruta.end());
 
-    cout << "Ruta mas corta: ";
-    for (size_t i = 0; i < ruta.size(); ++i) {
-        cout << ruta[i];
-        if (i + 1 < ruta.size()) cout << " -> ";
+    shared_ptr<const MotorElegido> motor = this->motor();
+    PuntosCriticos criticos = buscarPuntosCriticos(*motor);
+
+    cout << "\n========= CONECTIVIDAD =========\n";
+    int componentes = cantidadComponentes();
+    if (componentes == 1)
+        cout << "La red es conexa.\n";
+    else
+        cout << "La red está partida en " << componentes << " componentes.\n";
+
+    cout << "Enlaces puente (" << criticos.puentes.size() << "): ";
+    if (criticos.puentes.empty()) cout << "ninguno";
+    for (size_t i = 0; i < criticos.puentes.size(); ++i) {
+        auto [a, b, c] = enlaceDelMotor(*motor, criticos.puentes[i]);
+        cout << (i ? ", " : "") << "R" << a + 1 << "-R" << b + 1;
     }
-    cout << " | Costo total: " << dist[nombreDestino] << "\n";
+    cout << "\n";
+
+    cout << "Puntos de articulación (" << criticos.articulaciones.size() << "): ";
+    if (criticos.articulaciones.empty()) cout << "ninguno";
+    for (size_t i = 0; i < criticos.articulaciones.size(); ++i)
+        cout << (i ? ", " : "") << "R" << criticos.articulaciones[i] + 1;
+    cout << "\n================================\n";
 }
@@ -3,8 +3,13 @@
 #define RED_H
 
 #include "enrutador.h"
+#include "motorrutas.h"
+#include "conectividad.h"
+#include "diario.h"
+#include <memory>
 #include <vector>
 #include <string>
+#include <tuple>
 //#include <utility>
 //#include <iostream>
 //#include <queue>
@@ -15,6 +20,19 @@ class Red {
 private:
     std::vector<Router*> enrutadores; // Lista de enrutadores de la red
     std::string rutaArchivo;          // Ruta del archivo de guardado (opcional)
+    mutable Conectividad conectividad; // Componentes; se reconstruye tras borrados
+    mutable std::shared_ptr<const MotorElegido> motorRutas; // nulo tras cada cambio
+    mutable DiarioCambios diario;      // Diario del archivo base asociado
+    mutable std::vector<RegistroCambio> cambiosPendientes; // Cambios aún no guardados
+    bool reproduciendo = false;        // true mientras se aplica el diario al cargar
+    mutable bool enArchivo = false;    // true si se cargó o guardó alguna vez
+
+    void actualizarConectividad() const;
+    void insertarEnrutador();
+    bool quitarEnrutador(int id);
+    void registrarCambio(const RegistroCambio& cambio);
+    void aplicarCambio(const RegistroCambio& cambio);
+    bool sinEnrutadoresAislados() const;
 
 public:
     // ===========================
@@ -31,10 +49,16 @@ public:
     void mostrarRed() const;      // Muestra la matriz de costos mínimos entre todos los enrutadores
 
     void guardarEnArchivo(const std::string& nombreArchivo) const; // Guarda la red en un archivo
-    void cargarDesdeArchivo(const std::string& nombreArchivo);     // Carga la red desde un archivo
+    bool cargarDesdeArchivo(const std::string& nombreArchivo);     // Carga la red desde un archivo
 
     void calcularRutaMasCorta(int origen, int destino);            // Aplica Dijkstra entre dos enrutadores
+    void calcularKRutas(int origen, int destino, int k,
+                        bool formatoMaquina = false) const;         // k rutas simples más cortas (Yen)
     void mostrarTablasDeEnrutamiento();                            // Muestra la tabla de enrutamiento de cada enrutador
+    void simularTrafico(const std::string& archivoDemandas, int cantidadTop,
+                        bool repartirIgualCosto) const;             // Carga por enlace de una matriz de demandas
+    void mostrarCentralidad(int cantidadTop, double errorMaximo = 0) const; // Enrutadores y enlaces críticos (Brandes)
+    void mostrarConectividad() const;                              // Componentes, puentes y puntos de articulación
 
     // ===========================
     // Gestión de enrutadores
@@ -47,6 +71,34 @@ public:
     // ===========================
     void agregarEnlace();          // Agrega un enlace entre dos enrutadores
     void eliminarEnlace();         // Elimina un enlace entre dos enrutadores
+
+    // Versiones sin entrada por consola (usadas por el servidor de consultas).
+    // Devuelven false si los IDs no son válidos (o el costo es negativo).
+    bool conectar(int id1, int id2, int costo);
+    bool desconectar(int id1, int id2);
+
+    // ===========================
+    // Consultas
+    // ===========================
+    int cantidadEnrutadores() const;
+    int cantidadEnlaces() const;
+    // true si hay cambios que se perderían al descartar la red
+    bool tieneCambiosSinGuardar() const;
+    // Enlaces únicos (idMenor, idMayor, costo) ordenados por id
+    std::vector<std::tuple<int,int,int>> obtenerEnlaces() const;
+    // Motor de rutas de la red actual. Se arma (eligiendo sus tipos) en la
+    // primera consulta después de cargar o editar y se reutiliza hasta el
+    // próximo cambio; el puntero sigue siendo válido aunque la red cambie.
+    std::shared_ptr<const MotorElegido> motor() const;
+    // Costos mínimos de cada origen a cada destino (ids 1..N), sin imprimir.
+    // IDs inválidos y pares sin conexión quedan en costoInfinito<uint64_t>().
+    TablaDistancias<std::uint64_t> distanciasEntre(const std::vector<int>& origenes,
+                                    const std::vector<int>& destinos, int hilos = 0) const;
+
+    // Alcanzabilidad sin buscar rutas: O(α(n)) por consulta
+    bool estanConectados(int id1, int id2) const;
+    int cantidadComponentes() const;
+    bool esConexa() const;
 };
 
 #endif // RED_H
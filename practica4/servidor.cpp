@@ -0,0 +1,522 @@
+#include "servidor.h"
+#include "caminosk.h"
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+using namespace std;
+
+// ============================
+// Histograma de latencias
+// ============================
+HistogramaLatencia::HistogramaLatencia() {
+    for (auto& c : cubetas) c.store(0, memory_order_relaxed);
+}
+
+int HistogramaLatencia::indice(uint64_t v) {
+    if (v < 16) return (int)v;
+    int e = 63 - __builtin_clzll(v);           // e >= 4
+    int sub = (int)((v >> (e - 3)) & 7);
+    return 16 + (e - 4) * 8 + sub;
+}
+
+uint64_t HistogramaLatencia::limiteSuperior(int i) {
+    if (i < 16) return (uint64_t)i;
+    int e = (i - 16) / 8 + 4;
+    int sub = (i - 16) % 8;
+    uint64_t ancho = 1ULL << (e - 3);
+    return (uint64_t)(8 + sub) * ancho + ancho - 1;
+}
+
+void HistogramaLatencia::registrar(uint64_t microsegundos) {
+    cubetas[indice(microsegundos)].fetch_add(1, memory_order_relaxed);
+}
+
+uint64_t HistogramaLatencia::total() const {
+    uint64_t t = 0;
+    for (auto& c : cubetas) t += c.load(memory_order_relaxed);
+    return t;
+}
+
+uint64_t HistogramaLatencia::percentil(double p) const {
+    uint64_t t = total();
+    if (t == 0) return 0;
+    uint64_t objetivo = (uint64_t)(p * (double)t);
+    if (objetivo == 0) objetivo = 1;
+    uint64_t acumulado = 0;
+    for (int i = 0; i < CUBETAS; ++i) {
+        acumulado += cubetas[i].load(memory_order_relaxed);
+        if (acumulado >= objetivo) return limiteSuperior(i);
+    }
+    return limiteSuperior(CUBETAS - 1);
+}
+
+// ============================
+// Señales
+// ============================
+static volatile sig_atomic_t senalRecibida = 0;
+
+static void manejarSenal(int) {
+    senalRecibida = 1;
+}
+
+static void noBloqueante(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// ============================
+// Constructor y destructor
+// ============================
+ServidorConsultas::ServidorConsultas(Red& red, const string& rutaSocket, int hilos,
+                                     const string& archivoRed)
+    : red(red), rutaSocket(rutaSocket), archivoRed(archivoRed), cantidadHilos(hilos) {
+    if (cantidadHilos <= 0) cantidadHilos = (int)thread::hardware_concurrency();
+    if (cantidadHilos <= 0) cantidadHilos = 1;
+    motor = red.motor();
+}
+
+ServidorConsultas::~ServidorConsultas() {
+    detener();
+    for (auto& t : trabajadores)
+        if (t.joinable()) t.join();
+    for (auto& [id, c] : conexiones) close(c.fd);
+    if (fdEscucha >= 0) {
+        close(fdEscucha);
+        unlink(rutaSocket.c_str());
+    }
+    if (tuberia[0] >= 0) close(tuberia[0]);
+    if (tuberia[1] >= 0) close(tuberia[1]);
+}
+
+bool ServidorConsultas::abrirSocket() {
+    sockaddr_un dir{};
+    if (rutaSocket.size() >= sizeof(dir.sun_path)) {
+        cerr << "Ruta de socket demasiado larga: " << rutaSocket << endl;
+        return false;
+    }
+
+    fdEscucha = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fdEscucha < 0) {
+        cerr << "No se pudo crear el socket: " << strerror(errno) << endl;
+        return false;
+    }
+
+    dir.sun_family = AF_UNIX;
+    strncpy(dir.sun_path, rutaSocket.c_str(), sizeof(dir.sun_path) - 1);
+    unlink(rutaSocket.c_str()); // restos de una ejecución anterior
+
+    if (bind(fdEscucha, (sockaddr*)&dir, sizeof(dir)) < 0 || listen(fdEscucha, 128) < 0) {
+        cerr << "No se pudo escuchar en " << rutaSocket << ": " << strerror(errno) << endl;
+        close(fdEscucha);
+        fdEscucha = -1;
+        return false;
+    }
+    noBloqueante(fdEscucha);
+
+    if (pipe(tuberia) < 0) {
+        cerr << "No se pudo crear la tubería interna: " << strerror(errno) << endl;
+        return false;
+    }
+    noBloqueante(tuberia[0]);
+    noBloqueante(tuberia[1]);
+    return true;
+}
+
+// ============================
+// Bucle de eventos
+// ============================
+bool ServidorConsultas::ejecutar() {
+    if (!abrirSocket()) return false;
+
+    senalRecibida = 0;
+    signal(SIGINT, manejarSenal);
+    signal(SIGTERM, manejarSenal);
+    signal(SIGPIPE, SIG_IGN);
+
+    activo = true;
+    for (int i = 0; i < cantidadHilos; ++i)
+        trabajadores.emplace_back(&ServidorConsultas::trabajar, this);
+
+    cout << "Servidor escuchando en " << rutaSocket << " ("
+         << red.cantidadEnrutadores() << " enrutadores, "
+         << cantidadHilos << " hilos)\n";
+
+    vector<pollfd> fds;
+    vector<uint64_t> ids;
+    while (activo && !senalRecibida) {
+        fds.clear();
+        ids.clear();
+        fds.push_back({fdEscucha, POLLIN, 0});
+        fds.push_back({tuberia[0], POLLIN, 0});
+        for (auto& [id, c] : conexiones) {
+            short eventos = 0;
+            if (!c.cerrar) eventos |= POLLIN;
+            if (!c.salida.empty()) eventos |= POLLOUT;
+            fds.push_back({c.fd, eventos, 0});
+            ids.push_back(id);
+        }
+
+        if (poll(fds.data(), fds.size(), 200) < 0) {
+            if (errno == EINTR) continue;
+            cerr << "Error en poll: " << strerror(errno) << endl;
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) aceptar();
+        if (fds[1].revents & POLLIN) recogerListos();
+
+        for (size_t i = 0; i < ids.size(); ++i) {
+            auto it = conexiones.find(ids[i]);
+            if (it == conexiones.end()) continue;
+            Conexion& c = it->second;
+            bool ok = true;
+            if (fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) ok = leer(ids[i], c);
+            if (ok && (fds[i + 2].revents & POLLOUT)) ok = escribir(c);
+            if (!ok) {
+                c.cerrar = true;
+                c.salida.clear();
+            }
+        }
+
+        // Cerrar conexiones terminadas sin lotes pendientes
+        for (auto it = conexiones.begin(); it != conexiones.end(); ) {
+            Conexion& c = it->second;
+            if (c.cerrar && !c.ocupada && c.salida.empty()) {
+                close(c.fd);
+                it = conexiones.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Detener el pool
+    activo = false;
+    hayTareas.notify_all();
+    for (auto& t : trabajadores) t.join();
+    trabajadores.clear();
+
+    // Entregar lo que ya se había respondido (p. ej. el "OK" de "apagar")
+    recogerListos();
+    for (auto& [id, c] : conexiones) escribir(c);
+
+    cout << "Servidor detenido. Peticiones atendidas: " << histograma.total()
+         << " | p50: " << histograma.percentil(0.50) << " us"
+         << " | p99: " << histograma.percentil(0.99) << " us\n";
+    return true;
+}
+
+void ServidorConsultas::detener() {
+    activo = false;
+    hayTareas.notify_all();
+    avisar();
+}
+
+void ServidorConsultas::avisar() {
+    if (tuberia[1] >= 0) {
+        char b = 1;
+        ssize_t r = write(tuberia[1], &b, 1); // si la tubería está llena ya hay aviso
+        (void)r;
+    }
+}
+
+void ServidorConsultas::aceptar() {
+    while (true) {
+        int fd = accept(fdEscucha, nullptr, nullptr);
+        if (fd < 0) return; // EAGAIN: no hay más conexiones en cola
+        noBloqueante(fd);
+        Conexion c;
+        c.fd = fd;
+        conexiones.emplace(siguienteConexion++, std::move(c));
+    }
+}
+
+bool ServidorConsultas::leer(uint64_t id, Conexion& c) {
+    char buffer[16384];
+    while (true) {
+        ssize_t n = read(c.fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            c.entrada.append(buffer, (size_t)n);
+            continue;
+        }
+        if (n == 0) {
+            c.cerrar = true; // el cliente no enviará más, pero se responde lo pendiente
+            break;
+        }
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        return false;
+    }
+    if (!c.ocupada) despacharLote(id, c);
+    return true;
+}
+
+bool ServidorConsultas::escribir(Conexion& c) {
+    size_t enviado = 0;
+    while (enviado < c.salida.size()) {
+        ssize_t n = send(c.fd, c.salida.data() + enviado, c.salida.size() - enviado, MSG_NOSIGNAL);
+        if (n > 0) { enviado += (size_t)n; continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;
+    }
+    c.salida.erase(0, enviado);
+    return true;
+}
+
+// Todas las líneas completas recibidas forman un lote; mientras el lote está
+// en el pool las nuevas líneas se acumulan y salen en el lote siguiente, así
+// las respuestas de una conexión conservan el orden de las peticiones.
+void ServidorConsultas::despacharLote(uint64_t id, Conexion& c) {
+    size_t ultimo = c.entrada.rfind('\n');
+    if (ultimo == string::npos) return;
+
+    Lote lote;
+    lote.conexion = id;
+    lote.llegada = Reloj::now();
+    size_t inicio = 0;
+    while (inicio <= ultimo) {
+        size_t fin = c.entrada.find('\n', inicio);
+        string linea = c.entrada.substr(inicio, fin - inicio);
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        if (!linea.empty()) lote.lineas.push_back(std::move(linea));
+        inicio = fin + 1;
+    }
+    c.entrada.erase(0, ultimo + 1);
+    if (lote.lineas.empty()) return;
+
+    c.ocupada = true;
+    {
+        lock_guard<mutex> lock(mutexTareas);
+        tareas.push_back(std::move(lote));
+    }
+    hayTareas.notify_one();
+}
+
+void ServidorConsultas::recogerListos() {
+    char basura[256];
+    while (read(tuberia[0], basura, sizeof(basura)) > 0) {}
+
+    vector<Lote> terminados;
+    {
+        lock_guard<mutex> lock(mutexListos);
+        terminados.swap(listos);
+    }
+
+    for (auto& lote : terminados) {
+        auto it = conexiones.find(lote.conexion);
+        if (it == conexiones.end()) continue;
+        Conexion& c = it->second;
+        c.ocupada = false;
+        c.salida += lote.respuesta;
+        if (lote.cerrar) {
+            c.cerrar = true;
+            c.entrada.clear();
+        }
+        despacharLote(lote.conexion, c);
+        if (!escribir(c)) {
+            c.cerrar = true;
+            c.salida.clear();
+        }
+    }
+}
+
+// ============================
+// Pool de trabajadores
+// ============================
+void ServidorConsultas::trabajar() {
+    while (true) {
+        Lote lote;
+        {
+            unique_lock<mutex> lock(mutexTareas);
+            hayTareas.wait(lock, [this]{ return !tareas.empty() || !activo; });
+            if (tareas.empty()) return;
+            lote = std::move(tareas.front());
+            tareas.pop_front();
+        }
+
+        procesarLote(lote);
+
+        {
+            lock_guard<mutex> lock(mutexListos);
+            listos.push_back(std::move(lote));
+        }
+        avisar();
+    }
+}
+
+void ServidorConsultas::procesarLote(Lote& lote) {
+    for (auto& linea : lote.lineas) {
+        lote.respuesta += procesarLinea(linea, lote.cerrar);
+        lote.respuesta += '\n';
+        auto espera = chrono::duration_cast<chrono::microseconds>(Reloj::now() - lote.llegada);
+        histograma.registrar((uint64_t)espera.count());
+        if (lote.cerrar) break;
+    }
+}
+
+static string nombre(int indice) {
+    return "R" + to_string(indice + 1);
+}
+
+string ServidorConsultas::procesarLinea(const string& linea, bool& cerrar) {
+    istringstream in(linea);
+    string comando;
+    in >> comando;
+
+    // Las consultas trabajan sobre una instantánea inmutable del motor: las
+    // ediciones publican un motor nuevo sin bloquear a los lectores.
+    shared_ptr<const MotorElegido> m = atomic_load(&motor);
+    int n = visit([](const auto& grafo) { return grafo.cantidadNodos(); }, *m);
+    auto valido = [n](int id) { return id >= 1 && id <= n; };
+
+    if (comando == "ruta" || comando == "distancia") {
+        int o, d;
+        if (!(in >> o >> d)) return "ERR Uso: " + comando + " <origen> <destino>";
+        if (!valido(o) || !valido(d)) return "ERR IDs inválidos";
+
+        return visit([&](const auto& grafo) {
+            vector<int> ruta;
+            typename decay_t<decltype(grafo)>::TipoCosto costo = 0;
+            bool hay = grafo.rutaMasCorta(o - 1, d - 1, ruta, costo);
+            if (comando == "distancia") return hay ? "OK " + textoCosto(costo) : string("OK -");
+            if (!hay) return "ERR No existe ruta entre R" + to_string(o) + " y R" + to_string(d);
+
+            string r = "OK ";
+            for (size_t i = 0; i < ruta.size(); ++i) {
+                r += nombre(ruta[i]);
+                if (i + 1 < ruta.size()) r += " -> ";
+            }
+            return r + " | Costo total: " + textoCosto(costo);
+        }, *m);
+    }
+
+    if (comando == "tabla") {
+        int o;
+        if (!(in >> o)) return "ERR Uso: tabla <origen>";
+        if (!valido(o)) return "ERR IDs inválidos";
+
+        return visit([&](const auto& grafo) {
+            using Motor = decay_t<decltype(grafo)>;
+            vector<typename Motor::TipoCosto> dist;
+            vector<int> previo, orden;
+            grafo.dijkstra(o - 1, dist, previo, &orden);
+            vector<int> salto = primerosSaltos(o - 1, previo, orden);
+
+            string r = "OK";
+            for (int v = 0; v < n; ++v) {
+                r += " " + nombre(v) + ":";
+                if (dist[v] == Motor::SIN_CONEXION) { r += "-:-"; continue; }
+                r += textoCosto(dist[v]) + ":" + (salto[v] < 0 ? string("-") : nombre(salto[v]));
+            }
+            return r;
+        }, *m);
+    }
+
+    if (comando == "kcaminos") {
+        int o, d, k;
+        if (!(in >> o >> d >> k)) return "ERR Uso: kcaminos <origen> <destino> <k>";
+        if (!valido(o) || !valido(d) || k <= 0) return "ERR IDs inválidos";
+        k = min(k, MAX_KCAMINOS);
+
+        vector<CaminoK> caminos = kCaminosMasCortos(*m, o - 1, d - 1, k, 1);
+        string r = "OK";
+        for (size_t i = 0; i < caminos.size(); ++i) {
+            r += i == 0 ? " " : ";";
+            r += to_string(caminos[i].costo) + ":";
+            for (size_t j = 0; j < caminos[i].nodos.size(); ++j)
+                r += (j ? "," : "") + nombre(caminos[i].nodos[j]);
+        }
+        return r;
+    }
+
+    if (comando == "matriz") {
+        // matriz 1,2,3 7,8 -> filas separadas por ';'
+        string listaO, listaD;
+        if (!(in >> listaO >> listaD)) return "ERR Uso: matriz <o1,o2,...> <d1,d2,...>";
+        auto leerIds = [&](const string& lista, vector<int>& indices) {
+            istringstream campos(lista);
+            string campo;
+            while (getline(campos, campo, ',')) {
+                int id = atoi(campo.c_str());
+                if (!valido(id)) return false;
+                indices.push_back(id - 1);
+            }
+            return !indices.empty();
+        };
+        vector<int> origenes, destinos;
+        if (!leerIds(listaO, origenes) || !leerIds(listaD, destinos)) return "ERR IDs inválidos";
+
+        return visit([&](const auto& grafo) {
+            using Motor = decay_t<decltype(grafo)>;
+            // Un solo hilo: el paralelismo ya lo da el pool entre peticiones
+            auto t = grafo.tablaDistancias(origenes, destinos, 1);
+            string r = "OK";
+            for (int i = 0; i < t.filas; ++i) {
+                r += i == 0 ? " " : ";";
+                for (int j = 0; j < t.columnas; ++j) {
+                    if (j > 0) r += " ";
+                    r += t.en(i, j) == Motor::SIN_CONEXION ? string("-") : textoCosto(t.en(i, j));
+                }
+            }
+            return r;
+        }, *m);
+    }
+
+    if (comando == "enlace" || comando == "quitar") {
+        int a, b, costo = 0;
+        if (!(in >> a >> b) || (comando == "enlace" && !(in >> costo)))
+            return comando == "enlace" ? "ERR Uso: enlace <a> <b> <costo>" : "ERR Uso: quitar <a> <b>";
+        if (comando == "enlace" && costo < 0) return "ERR Costo inválido";
+
+        lock_guard<mutex> lock(mutexEdicion);
+        bool ok = comando == "enlace" ? red.conectar(a, b, costo) : red.desconectar(a, b);
+        if (!ok) return "ERR IDs inválidos";
+        atomic_store(&motor, red.motor());
+        return "OK";
+    }
+
+    if (comando == "conexa") {
+        lock_guard<mutex> lock(mutexEdicion); // Red comprime caminos al consultar
+        int componentes = red.cantidadComponentes();
+        return string(componentes <= 1 ? "OK si" : "OK no") + " componentes=" + to_string(componentes);
+    }
+
+    if (comando == "guardar") {
+        if (archivoRed.empty()) return "ERR La red no se cargó desde un archivo";
+        lock_guard<mutex> lock(mutexEdicion);
+        red.guardarEnArchivo(archivoRed);
+        return "OK";
+    }
+
+    if (comando == "info")
+        return "OK enrutadores=" + to_string(n) + " enlaces="
+               + to_string(visit([](const auto& grafo) { return grafo.cantidadEnlaces(); }, *m))
+               + " hilos=" + to_string(cantidadHilos);
+
+    if (comando == "stats")
+        return "OK peticiones=" + to_string(histograma.total())
+               + " p50_us=" + to_string(histograma.percentil(0.50))
+               + " p99_us=" + to_string(histograma.percentil(0.99));
+
+    if (comando == "salir") {
+        cerrar = true;
+        return "OK";
+    }
+
+    if (comando == "apagar") {
+        cerrar = true;
+        detener();
+        return "OK";
+    }
+
+    return "ERR Comando desconocido: " + comando;
+}
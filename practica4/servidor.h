@@ -0,0 +1,137 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include "red.h"
+#include "motorrutas.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ===========================
+// Histograma de latencias
+// ===========================
+// Cubetas log-lineales (8 por potencia de 2) en microsegundos: registrar es
+// un incremento atómico y los percentiles tienen un error relativo < 12.5%.
+class HistogramaLatencia {
+public:
+    HistogramaLatencia();
+    void registrar(uint64_t microsegundos);
+    uint64_t percentil(double p) const;   // p en [0,1], en microsegundos
+    uint64_t total() const;
+
+private:
+    static constexpr int CUBETAS = 16 + 8 * 60;
+    std::array<std::atomic<uint64_t>, CUBETAS> cubetas;
+
+    static int indice(uint64_t v);
+    static uint64_t limiteSuperior(int indice);
+};
+
+// ===========================
+// Servidor de consultas
+// ===========================
+// Carga una red una sola vez y atiende peticiones de texto (una por línea)
+// sobre un socket Unix. Un hilo hace el bucle de eventos con poll(); las
+// líneas completas de cada conexión se agrupan en un lote que procesa un hilo
+// del pool, y las respuestas del lote se escriben juntas y en orden.
+// Protocolo:
+//   ruta <o> <d>            -> OK R1 -> R4 -> R7 | Costo total: 12
+//   distancia <o> <d>       -> OK 12   (o "OK -" si no hay conexión)
+//   tabla <o>               -> OK R1:0:- R2:5:R2 ...  (destino:costo:salto)
+//   matriz <o,o,..> <d,d,..> -> OK 5 7;3 -   (filas por origen, separadas por ';')
+//   kcaminos <o> <d> <k>    -> OK 12:R1,R4,R7;15:R1,R2,R7  (k se limita a MAX_KCAMINOS)
+//   enlace <a> <b> <costo>  -> OK      (agrega o cambia el costo)
+//   quitar <a> <b>          -> OK
+//   conexa                  -> OK si componentes=1
+//   guardar                 -> OK      (agrega las ediciones al diario del archivo)
+//   info | stats | salir | apagar
+// Tope de 'k' en kcaminos: cada ruta extra cuesta un Yen más y memoria en
+// los candidatos, y una sola petición no debe acaparar un hilo del pool.
+constexpr int MAX_KCAMINOS = 100;
+
+// Al agregar un comando, sumarlo también a COMANDOS_SERVIDOR.
+constexpr const char* COMANDOS_SERVIDOR =
+    "ruta, distancia, tabla, matriz, kcaminos, enlace, quitar, conexa, guardar, "
+    "info, stats, salir, apagar";
+
+class ServidorConsultas {
+public:
+    // 'archivoRed' es el archivo del que se cargó la red (para "guardar")
+    ServidorConsultas(Red& red, const std::string& rutaSocket, int hilos = 0,
+                      const std::string& archivoRed = "");
+    ~ServidorConsultas();
+
+    bool ejecutar();   // bloquea hasta "apagar" o SIGINT/SIGTERM
+    void detener();
+
+    const HistogramaLatencia& latencias() const { return histograma; }
+
+private:
+    using Reloj = std::chrono::steady_clock;
+
+    struct Conexion {
+        int fd = -1;
+        std::string entrada;   // bytes leídos sin procesar
+        std::string salida;    // respuestas pendientes de escribir
+        bool ocupada = false;  // hay un lote en el pool
+        bool cerrar = false;   // cerrar al vaciar la salida
+    };
+
+    struct Lote {
+        uint64_t conexion = 0;
+        std::vector<std::string> lineas;
+        Reloj::time_point llegada;
+        std::string respuesta;
+        bool cerrar = false;
+    };
+
+    Red& red;
+    std::string rutaSocket;
+    std::string archivoRed;
+    int cantidadHilos;
+    int fdEscucha = -1;
+    int tuberia[2] = {-1, -1}; // despierta al bucle cuando hay lotes listos
+
+    std::shared_ptr<const MotorElegido> motor; // se reemplaza tras cada edición
+    std::mutex mutexEdicion;
+
+    std::map<uint64_t, Conexion> conexiones;
+    uint64_t siguienteConexion = 1;
+
+    std::vector<std::thread> trabajadores;
+    std::mutex mutexTareas;
+    std::condition_variable hayTareas;
+    std::deque<Lote> tareas;
+    std::mutex mutexListos;
+    std::vector<Lote> listos;
+
+    std::atomic<bool> activo{false};
+    HistogramaLatencia histograma;
+
+    bool abrirSocket();
+    void aceptar();
+    bool leer(uint64_t id, Conexion& c);
+    bool escribir(Conexion& c);
+    void despacharLote(uint64_t id, Conexion& c);
+    void recogerListos();
+    void trabajar();
+    void procesarLote(Lote& lote);
+    std::string procesarLinea(const std::string& linea, bool& cerrar);
+    void avisar();
+};
+
+// Herramientas del lado cliente
+int ejecutarCliente(const std::string& rutaSocket);
+int ejecutarGeneradorCarga(const std::string& rutaSocket, int conexiones,
+                           int peticionesPorConexion, int profundidad);
+
+#endif // SERVIDOR_H
@@ -0,0 +1,150 @@
+#include "trafico.h"
+#include "paralelo.h"
+#include <fstream>
+#include <algorithm>
+#include <numeric>
+using namespace std;
+
+// ============================
+// Lectura de la matriz de demandas
+// ============================
+static int leerId(const string& texto) {
+    // Acepta "R12" o "12"
+    size_t inicio = (!texto.empty() && (texto[0] == 'R' || texto[0] == 'r')) ? 1 : 0;
+    if (inicio >= texto.size()) return -1;
+    int id = 0;
+    for (size_t i = inicio; i < texto.size(); ++i) {
+        if (texto[i] < '0' || texto[i] > '9') return -1;
+        id = id * 10 + (texto[i] - '0');
+    }
+    return id;
+}
+
+bool leerDemandas(const string& archivo, int cantidadNodos,
+                  vector<Demanda>& demandas, long long& descartadas) {
+    ifstream in(archivo);
+    if (!in.is_open()) return false;
+
+    demandas.clear();
+    descartadas = 0;
+    string a, b;
+    double volumen;
+    while (in >> a >> b >> volumen) {
+        int o = leerId(a), d = leerId(b);
+        if (o <= 0 || d <= 0 || o > cantidadNodos || d > cantidadNodos || volumen < 0) {
+            ++descartadas;
+            continue;
+        }
+        demandas.push_back({o - 1, d - 1, volumen});
+    }
+    return true;
+}
+
+// ============================
+// Simulación
+// ============================
+vector<int> ResultadoTrafico::masCargados(int cantidad) const {
+    vector<int> indices(cargaEnlace.size());
+    iota(indices.begin(), indices.end(), 0);
+    cantidad = max(0, min(cantidad, (int)indices.size()));
+    partial_sort(indices.begin(), indices.begin() + cantidad, indices.end(), [this](int a, int b) {
+        if (cargaEnlace[a] != cargaEnlace[b]) return cargaEnlace[a] > cargaEnlace[b];
+        return a < b;
+    });
+    indices.resize(cantidad);
+    return indices;
+}
+
+template <class Motor>
+static ResultadoTrafico enrutarDemandas(const Motor& motor, const vector<Demanda>& demandas,
+                                        bool repartirIgualCosto, int hilos) {
+    using Costo = typename Motor::TipoCosto;
+    int n = motor.cantidadNodos();
+    int m = motor.cantidadEnlaces();
+    ResultadoTrafico resultado;
+    resultado.cargaEnlace.assign(m, 0.0);
+    resultado.demandas = (long long)demandas.size();
+
+    // Agrupar las demandas por origen (ordenamiento por conteo)
+    vector<int> inicio(n + 1, 0);
+    for (auto& d : demandas) ++inicio[d.origen + 1];
+    for (int i = 0; i < n; ++i) inicio[i + 1] += inicio[i];
+    vector<pair<int,double>> porOrigen(demandas.size());
+    vector<int> pos(inicio.begin(), inicio.end() - 1);
+    for (auto& d : demandas) porOrigen[pos[d.origen]++] = {d.destino, d.volumen};
+
+    vector<int> origenes;
+    for (int o = 0; o < n; ++o)
+        if (inicio[o + 1] > inicio[o]) origenes.push_back(o);
+
+    struct PorHilo {
+        ArbolCaminos<Costo> arbol;
+        vector<double> flujo;
+        vector<double> carga;
+        double total = 0;
+        double sinRuta = 0;
+    };
+    vector<PorHilo> locales(hilosAUsar(hilos, (int)origenes.size()));
+
+    paraCadaEnParalelo((int)origenes.size(), hilos, [&](int i, int h) {
+        int origen = origenes[i];
+        PorHilo& local = locales[h];
+        if (local.flujo.empty()) {
+            local.flujo.assign(n, 0.0);
+            local.carga.assign(m, 0.0);
+        }
+
+        ArbolCaminos<Costo>& a = local.arbol;
+        motor.arbolCaminos(origen, a);
+
+        for (int k = inicio[origen]; k < inicio[origen + 1]; ++k) {
+            auto [destino, volumen] = porOrigen[k];
+            local.total += volumen;
+            if (destino == origen) continue;
+            if (a.dist[destino] == Motor::SIN_CONEXION) {
+                local.sinRuta += volumen;
+                continue;
+            }
+            local.flujo[destino] += volumen;
+        }
+
+        // Empujar el flujo hacia el origen, de los nodos más lejanos a los más cercanos
+        for (int idx = (int)a.orden.size() - 1; idx > 0; --idx) {
+            int v = a.orden[idx];
+            double f = local.flujo[v];
+            if (f == 0) continue;
+            local.flujo[v] = 0;
+
+            if (!repartirIgualCosto) {
+                int e = motor.enlaceDeArco(a.arcoPrevio[v]);
+                local.carga[e] += f;
+                local.flujo[motor.otroExtremo(e, v)] += f;
+                continue;
+            }
+
+            for (int k = motor.inicio(v); k < motor.fin(v); ++k) {
+                int u = motor.destino(k);
+                if (!a.predecesor(u, v, motor.costo(k))) continue;
+                double parte = f * a.fraccion(u, v);
+                local.carga[motor.enlaceDeArco(k)] += parte;
+                local.flujo[u] += parte;
+            }
+        }
+        local.flujo[origen] = 0;
+    });
+
+    for (auto& local : locales) {
+        resultado.volumenTotal += local.total;
+        resultado.volumenSinRuta += local.sinRuta;
+        for (int e = 0; e < (int)local.carga.size(); ++e)
+            resultado.cargaEnlace[e] += local.carga[e];
+    }
+    return resultado;
+}
+
+ResultadoTrafico simularTrafico(const MotorElegido& motor, const vector<Demanda>& demandas,
+                                bool repartirIgualCosto, int hilos) {
+    return visit([&](const auto& m) {
+        return enrutarDemandas(m, demandas, repartirIgualCosto, hilos);
+    }, motor);
+}
@@ -0,0 +1,40 @@
+#ifndef TRAFICO_H
+#define TRAFICO_H
+
+#include "motorrutas.h"
+#include <string>
+#include <vector>
+
+// Una demanda de la matriz de tráfico (índices 0-based del motor)
+struct Demanda {
+    int origen;
+    int destino;
+    double volumen;
+};
+
+struct ResultadoTrafico {
+    std::vector<double> cargaEnlace;   // carga por enlace del motor
+    long long demandas = 0;
+    double volumenTotal = 0;
+    double volumenSinRuta = 0;         // demandas entre nodos desconectados
+
+    // Índices de los 'cantidad' enlaces con más carga, de mayor a menor
+    std::vector<int> masCargados(int cantidad) const;
+};
+
+// Lee líneas "R<origen> R<destino> <volumen>" (ids 1..N). Las líneas con ids
+// fuera de 1..cantidadNodos se cuentan en 'descartadas'.
+bool leerDemandas(const std::string& archivo, int cantidadNodos,
+                  std::vector<Demanda>& demandas, long long& descartadas);
+
+// Enruta todas las demandas por caminos mínimos y acumula la carga por enlace.
+// Se hace un solo árbol por origen (no un camino por demanda): el flujo de
+// cada destino se empuja hacia el origen recorriendo el árbol de atrás hacia
+// adelante. Con 'repartirIgualCosto' el flujo se divide entre todos los
+// caminos de igual costo en proporción a cuántos caminos mínimos pasan por
+// cada predecesor. Los orígenes se reparten entre hilos, cada uno con su
+// propio arreglo de cargas que se suma al final.
+ResultadoTrafico simularTrafico(const MotorElegido& motor, const std::vector<Demanda>& demandas,
+                                bool repartirIgualCosto, int hilos = 0);
+
+#endif // TRAFICO_H